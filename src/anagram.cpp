@@ -0,0 +1,94 @@
+#include <algorithm>
+
+#include "anagram.hpp"
+
+using std::array;
+using std::string;
+using std::vector;
+
+// guard bit of every lane
+static const uint64_t guard {0x0842108421084210ULL};
+
+AnagramIndex::Signature AnagramIndex::pack(const array<unsigned int, 26>& counts)
+{
+	Signature sig {{0, 0, 0}};
+	for (unsigned int i = 0; i < 26; ++i)
+		sig[i / 12] |= uint64_t(std::min(counts[i], 15u)) << ((i % 12) * 5);
+	return sig;
+}
+
+AnagramIndex::AnagramIndex(const Dictionary& dictionary)
+{
+	vector<std::pair<Signature, string>> words;
+	words.reserve(dictionary.size());
+
+	dictionary.each_word([&words](const string& word)
+	{
+		array<unsigned int, 26> counts {};
+		for (char ch : word)
+			++counts[ch - 'A'];
+		words.push_back(std::make_pair(pack(counts), word));
+	});
+
+	// group words with the same letters
+	std::sort(words.begin(), words.end());
+
+	for (const auto& pair : words)
+	{
+		if (signatures.empty() || signatures.back() != pair.first)
+		{
+			uint32_t mask = 0;
+			for (unsigned int i = 0; i < 26; ++i)
+				if ((pair.first[i / 12] >> ((i % 12) * 5)) & 0xf)
+					mask |= 1 << i;
+
+			masks.push_back(mask);
+			signatures.push_back(pair.first);
+			firsts.push_back(offsets.size());
+		}
+
+		offsets.push_back(text.size());
+		text.append(pair.second);
+	}
+	firsts.push_back(offsets.size());
+	offsets.push_back(text.size());
+}
+
+vector<string> AnagramIndex::formable(const array<unsigned int, 26>& counts, char board) const
+{
+	array<unsigned int, 26> available(counts);
+	uint32_t required = 0;
+	if (board >= 'A' && board <= 'Z')
+	{
+		++available[board - 'A'];
+		required = 1 << (board - 'A');
+	}
+
+	uint32_t mask = 0;
+	for (unsigned int i = 0; i < 26; ++i)
+		if (available[i] > 0)
+			mask |= 1 << i;
+
+	// set guard bits so subtracting a smaller count never borrows from the next lane
+	Signature have = pack(available);
+	for (auto& block : have)
+		block |= guard;
+
+	vector<string> found;
+	for (size_t e = 0; e < masks.size(); ++e)
+	{
+		// cheap check on which letters are used first
+		if ((masks[e] & ~mask) != 0 || (masks[e] & required) != required)
+			continue;
+
+		// a lane's guard bit is cleared if the word needs more of that letter than we have
+		const Signature& need = signatures[e];
+		if ((((have[0] - need[0]) & (have[1] - need[1]) & (have[2] - need[2])) & guard) != guard)
+			continue;
+
+		for (uint32_t i = firsts[e]; i < firsts[e + 1]; ++i)
+			found.push_back(text.substr(offsets[i], offsets[i + 1] - offsets[i]));
+	}
+
+	return found;
+}
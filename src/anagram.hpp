@@ -0,0 +1,45 @@
+#ifndef ANAGRAM_HPP
+#define ANAGRAM_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "dictionary.hpp"
+#include "rack.hpp"
+
+// index of words by letter counts, for finding what a set of tiles can spell
+class AnagramIndex
+{
+	// letter counts packed 4 bits each into 5 bit lanes (12 letters per block),
+	// the spare bit in each lane catches borrows when comparing counts
+	typedef std::array<uint64_t, 3> Signature;
+
+	// one entry per distinct signature, kept in separate arrays so the
+	// first pass only has to scan the masks
+	std::vector<uint32_t> masks; // letters used
+	std::vector<Signature> signatures;
+	std::vector<uint32_t> firsts; // first word with each signature, plus end
+	std::vector<uint32_t> offsets; // start of each word in text, plus end
+	std::string text;
+
+	static Signature pack(const std::array<unsigned int, 26>& counts);
+public:
+	AnagramIndex(const Dictionary& dictionary);
+
+	// every word that can be spelled from counts, plus board letter if given (which the word must use)
+	std::vector<std::string> formable(const std::array<unsigned int, 26>& counts, char board = 0) const;
+
+	inline std::vector<std::string> formable(const Rack& rack, char board = 0) const
+	{
+		return formable(rack.get_counts(), board);
+	}
+
+	inline size_t size() const
+	{
+		return masks.size();
+	}
+};
+
+#endif
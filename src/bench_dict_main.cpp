@@ -0,0 +1,417 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#ifndef __MINGW32__
+#include <unistd.h>
+#endif
+
+#include "anagram.hpp"
+#include "bloom.hpp"
+#include "board.hpp"
+#include "bunch.hpp"
+#include "dictionary.hpp"
+#include "packed_words.hpp"
+#include "rack.hpp"
+
+namespace po = boost::program_options;
+using std::cout;
+using std::cerr;
+using std::endl;
+using std::string;
+using std::vector;
+
+typedef std::chrono::steady_clock bench_clock;
+typedef std::function<bool(const string&)> check_fn;
+typedef std::function<void(const vector<string>&, vector<bool>&)> batch_fn;
+
+// words looked up for one length distribution
+struct Queries
+{
+	string name;
+	vector<string> hits;
+	vector<string> misses;
+	vector<string> mixed; // alternating hits and misses
+	vector<string> prefixes; // leading part of each hit
+};
+
+// resident memory of this process in KiB, 0 if we can't tell
+static long resident_kib()
+{
+#ifndef __MINGW32__
+	std::ifstream statm("/proc/self/statm");
+	long size, resident;
+	if (statm >> size >> resident)
+		return resident * (sysconf(_SC_PAGESIZE) / 1024);
+#endif
+	return 0;
+}
+
+static double elapsed_ms(const bench_clock::time_point& start)
+{
+	return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+}
+
+// one result per line: engine,distribution,metric,value,unit
+static void report(const string& engine, const string& distribution, const string& metric, double value, const string& unit)
+{
+	cout << engine << ',' << distribution << ',' << metric << ',' << value << ',' << unit << endl;
+}
+
+// million lookups per second, counting how many were found
+static double throughput(const vector<string>& words, const check_fn& check, size_t& found)
+{
+	found = 0;
+	auto start = bench_clock::now();
+	for (const auto& word : words)
+		if (check(word))
+			++found;
+	return words.size() / elapsed_ms(start) / 1000.0;
+}
+
+static double batch_throughput(const vector<string>& words, unsigned int batch_size, const batch_fn& check, size_t& found)
+{
+	found = 0;
+	vector<string> batch;
+	vector<bool> valid;
+	auto start = bench_clock::now();
+	for (size_t i = 0; i < words.size(); i += batch_size)
+	{
+		batch.assign(words.begin() + i, words.begin() + std::min(words.size(), i + batch_size));
+		check(batch, valid);
+		for (bool v : valid)
+			if (v)
+				++found;
+	}
+	return words.size() / elapsed_ms(start) / 1000.0;
+}
+
+// run all lookup benchmarks for one engine
+static void bench_lookups(const string& engine, const vector<Queries>& distributions, unsigned int batch_size, const check_fn& check, const batch_fn& batch)
+{
+	for (const auto& queries : distributions)
+	{
+		size_t found;
+
+		report(engine, queries.name, "hit_rate", throughput(queries.hits, check, found), "Mops/s");
+		if (found != queries.hits.size())
+			cerr << "Warning: " << engine << " missed " << queries.hits.size() - found << " words\n";
+
+		report(engine, queries.name, "miss_rate", throughput(queries.misses, check, found), "Mops/s");
+		// only the bloom filter should get these wrong
+		report(engine, queries.name, "false_positives", queries.misses.empty() ? 0 : double(found) / queries.misses.size(), "ratio");
+
+		report(engine, queries.name, "batch_rate", batch_throughput(queries.mixed, batch_size, batch, found), "Mops/s");
+	}
+}
+
+// look up prefixes of words that are known to be in the dictionary
+static void bench_prefixes(const string& engine, const vector<Queries>& distributions, const Dictionary& dictionary)
+{
+	check_fn check = [&dictionary](const string& prefix) { return dictionary.is_prefix(prefix); };
+	for (const auto& queries : distributions)
+	{
+		size_t found;
+		report(engine, queries.name, "prefix_rate", throughput(queries.prefixes, check, found), "Mops/s");
+		if (found != queries.prefixes.size())
+			cerr << "Warning: " << engine << " missed " << queries.prefixes.size() - found << " prefixes\n";
+	}
+}
+
+// check batch one word at a time, for engines without a batch lookup
+static batch_fn one_by_one(const check_fn& check)
+{
+	return [check](const vector<string>& words, vector<bool>& valid)
+	{
+		valid.resize(words.size());
+		for (size_t i = 0; i < words.size(); ++i)
+			valid[i] = check(words[i]);
+	};
+}
+
+int main(int argc, char* argv[])
+{
+	// command line arguments
+	po::options_description desc("Bananagrams dictionary benchmark options");
+	desc.add_options()
+		("help",                                                         "show options")
+		("input",   po::value<string>()->default_value("words.txt"),     "word list to load")
+		("lookups", po::value<unsigned int>()->default_value(200000),    "words to look up per distribution")
+		("batch",   po::value<unsigned int>()->default_value(64),        "words per batched lookup")
+		("seed",    po::value<unsigned int>()->default_value(1),         "random seed for picking words")
+		("hands",   po::value<unsigned int>()->default_value(1000),      "hands to find anagrams for")
+		("moves",   po::value<unsigned int>()->default_value(20000),     "letters to move around a board")
+		("image",   po::value<string>()->default_value("bench_dict.dawg"), "where to write a binary image for timing its load, removed afterwards")
+	;
+
+	po::positional_options_description pos;
+	pos.add("input", 1);
+
+	po::variables_map opts;
+
+	try
+	{
+		po::store(po::command_line_parser(argc, argv).options(desc).positional(pos).run(), opts);
+
+		if (opts.count("help"))
+		{
+			cerr << desc << endl;
+			return 1;
+		}
+
+		po::notify(opts);
+	}
+	catch (po::error& e)
+	{
+		cerr << "Error: " << e.what() << endl << endl << desc << endl;
+		return 1;
+	}
+
+	string input = opts["input"].as<string>();
+	unsigned int lookups = opts["lookups"].as<unsigned int>();
+	unsigned int batch_size = std::max(1u, opts["batch"].as<unsigned int>());
+	unsigned int hands = std::max(1u, opts["hands"].as<unsigned int>());
+	unsigned int moves = std::max(1u, opts["moves"].as<unsigned int>());
+	string image_file = opts["image"].as<string>();
+	std::mt19937 rng {opts["seed"].as<unsigned int>()};
+
+	cout << "engine,distribution,metric,value,unit" << endl;
+
+	// the way games used to load their dictionary
+	long before = resident_kib();
+	auto start = bench_clock::now();
+	std::map<string, string> word_map;
+	{
+		std::ifstream words(input);
+		if (!words.is_open())
+		{
+			cerr << "Error: couldn't read dictionary " << input << endl;
+			return 1;
+		}
+
+		string line;
+		while (std::getline(words, line))
+		{
+			auto pos = line.find_first_of(' ');
+			if (pos == string::npos)
+				word_map[line] = "";
+			else
+				word_map[line.substr(0, pos)] = line.substr(pos + 1, string::npos);
+		}
+	}
+	report("map", "all", "load", elapsed_ms(start), "ms");
+	report("map", "all", "resident", resident_kib() - before, "KiB");
+
+	before = resident_kib();
+	start = bench_clock::now();
+	Dictionary dawg;
+	if (!dawg.load(input))
+	{
+		cerr << "Error: couldn't read dictionary " << input << endl;
+		return 1;
+	}
+	report("dawg", "all", "load", elapsed_ms(start), "ms");
+	report("dawg", "all", "resident", resident_kib() - before, "KiB");
+	report("dawg", "all", "footprint", dawg.footprint() / 1024.0, "KiB");
+
+	// what dictc output costs to load. the file was just written, so this is
+	// with a warm page cache, and pages only count as resident once touched
+	if (!dawg.save(image_file))
+	{
+		cerr << "Error: couldn't write image " << image_file << endl;
+		return 1;
+	}
+	before = resident_kib();
+	start = bench_clock::now();
+	Dictionary image;
+	bool image_loaded {image.load(image_file)};
+	report("dawg_image", "all", "load", elapsed_ms(start), "ms");
+	report("dawg_image", "all", "resident", resident_kib() - before, "KiB");
+	std::remove(image_file.c_str());
+	if (!image_loaded)
+	{
+		cerr << "Error: couldn't read image " << image_file << endl;
+		return 1;
+	}
+
+	before = resident_kib();
+	start = bench_clock::now();
+	PackedWords packed {dawg};
+	report("packed", "all", "load", elapsed_ms(start), "ms");
+	report("packed", "all", "resident", resident_kib() - before, "KiB");
+	report("packed", "all", "footprint", packed.footprint() / 1024.0, "KiB");
+
+	before = resident_kib();
+	start = bench_clock::now();
+	BloomFilter bloom {dawg.size()};
+	dawg.each_word([&bloom](const string& word) { bloom.add(word); });
+	report("bloom", "all", "load", elapsed_ms(start), "ms");
+	report("bloom", "all", "resident", resident_kib() - before, "KiB");
+	report("bloom", "all", "footprint", bloom.footprint() / 1024.0, "KiB");
+
+	// words of each length class, to pick lookups from
+	vector<string> all;
+	vector<string> by_length[3];
+	for (const auto& pair : word_map)
+	{
+		if (pair.first.empty())
+			continue;
+
+		all.push_back(pair.first);
+		if (pair.first.size() <= 4)
+			by_length[0].push_back(pair.first);
+		else if (pair.first.size() <= 8)
+			by_length[1].push_back(pair.first);
+		else
+			by_length[2].push_back(pair.first);
+	}
+
+	vector<Queries> distributions;
+	const char* names[] {"short", "medium", "long", "all"};
+	for (unsigned int d = 0; d < 4; ++d)
+	{
+		const vector<string>& pool = d < 3 ? by_length[d] : all;
+		if (pool.empty())
+			continue;
+
+		Queries queries;
+		queries.name = names[d];
+		for (unsigned int i = 0; i < lookups; ++i)
+		{
+			string word = pool[rng() % pool.size()];
+			queries.hits.push_back(word);
+			queries.prefixes.push_back(word.substr(0, 1 + rng() % word.size()));
+
+			// change letters until it isn't a word any more
+			for (unsigned int tries = 0; tries < 16 && word_map.count(word); ++tries)
+				word[rng() % word.size()] = 'A' + rng() % 26;
+			if (!word_map.count(word))
+				queries.misses.push_back(word);
+		}
+
+		for (size_t i = 0; i < queries.hits.size(); ++i)
+		{
+			queries.mixed.push_back(queries.hits[i]);
+			if (i < queries.misses.size())
+				queries.mixed.push_back(queries.misses[i]);
+		}
+
+		distributions.push_back(queries);
+	}
+
+	check_fn map_check = [&word_map](const string& word) { return word_map.count(word) > 0; };
+	bench_lookups("map", distributions, batch_size, map_check, one_by_one(map_check));
+
+	// batches use the packed keys once they are built
+	dawg.pack();
+
+	check_fn dawg_check = [&dawg](const string& word) { return dawg.check_word(word); };
+	bench_lookups("dawg", distributions, batch_size, dawg_check,
+		[&dawg](const vector<string>& words, vector<bool>& valid) { dawg.check_words(words, valid); });
+	bench_prefixes("dawg", distributions, dawg);
+
+	// same lookups against the mapped image
+	image.pack();
+	check_fn image_check = [&image](const string& word) { return image.check_word(word); };
+	bench_lookups("dawg_image", distributions, batch_size, image_check,
+		[&image](const vector<string>& words, vector<bool>& valid) { image.check_words(words, valid); });
+	bench_prefixes("dawg_image", distributions, image);
+
+	check_fn packed_check = [&packed](const string& word) { return packed.check_word(word); };
+	bench_lookups("packed", distributions, batch_size, packed_check,
+		[&packed](const vector<string>& words, vector<bool>& valid) { packed.check_words(words, valid); });
+
+	check_fn bloom_check = [&bloom](const string& word) { return bloom.maybe_contains(word); };
+	bench_lookups("bloom", distributions, batch_size, bloom_check, one_by_one(bloom_check));
+
+	before = resident_kib();
+	start = bench_clock::now();
+	AnagramIndex anagrams {dawg};
+	report("anagram", "all", "load", elapsed_ms(start), "ms");
+	report("anagram", "all", "resident", resident_kib() - before, "KiB");
+
+	// hands dealt from a full bunch: a starting hand, and a late game hand
+	// playing through a letter on the board
+	string bunch;
+	for (unsigned int i = 0; i < 26; ++i)
+		bunch.append(letter_count[i], 'A' + i);
+
+	for (unsigned int hand_size : {21u, 8u})
+	{
+		bool through_board {hand_size < 21};
+		string name {"hand" + std::to_string(hand_size) + (through_board ? "+1" : "")};
+		size_t found = 0;
+		double total_ms = 0;
+		for (unsigned int h = 0; h < hands; ++h)
+		{
+			std::shuffle(bunch.begin(), bunch.end(), rng);
+			Rack rack;
+			rack.add(bunch.substr(0, hand_size));
+
+			start = bench_clock::now();
+			found += anagrams.formable(rack, through_board ? bunch[hand_size] : 0).size();
+			total_ms += elapsed_ms(start);
+		}
+		report("anagram", name, "query", total_ms / hands, "ms");
+		report("anagram", name, "words", double(found) / hands, "count");
+	}
+
+	// the whole bunch spread over a board, moving one letter at a time the
+	// way a player does, and tinting runs that can't become words
+	std::shuffle(bunch.begin(), bunch.end(), rng);
+	const int side {int(std::sqrt(double(bunch.size())) * 1.5)};
+	Board board;
+	vector<Coord> placed;
+	for (char letter : bunch)
+	{
+		Coord pos;
+		do
+			pos = Coord {int(rng() % side), int(rng() % side)};
+		while (board.get(pos.x, pos.y) != 0);
+		board.place(pos.x, pos.y, letter);
+		placed.push_back(pos);
+	}
+
+	start = bench_clock::now();
+	board.recheck_prefixes(dawg);
+	report("board", "all", "first_check", elapsed_ms(start), "ms");
+
+	start = bench_clock::now();
+	board.recheck_prefixes(dawg);
+	report("board", "all", "recheck", elapsed_ms(start), "ms");
+
+	double move_ms = 0;
+	double check_ms = 0;
+	for (unsigned int m = 0; m < moves; ++m)
+	{
+		Coord& from = placed[rng() % placed.size()];
+		Coord to;
+		do
+			to = Coord {int(rng() % side), int(rng() % side)};
+		while (board.get(to.x, to.y) != 0);
+
+		start = bench_clock::now();
+		char letter {board.remove(from.x, from.y)};
+		board.place(to.x, to.y, letter);
+		move_ms += elapsed_ms(start);
+		from = to;
+
+		start = bench_clock::now();
+		board.check_prefixes(dawg);
+		check_ms += elapsed_ms(start);
+	}
+	report("board", "all", "move", move_ms / moves, "ms");
+	report("board", "all", "check", check_ms / moves, "ms");
+
+	return 0;
+}
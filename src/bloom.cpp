@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "bloom.hpp"
+
+using std::string;
+
+static const char magic[4] {'B', 'G', 'B', 'F'};
+
+BloomFilter::BloomFilter(uint32_t words, unsigned int bits_per_word)
+{
+	// optimal number of hashes is bits per word * ln 2
+	hashes = std::max(1, (int)std::lround(bits_per_word * std::log(2.0)));
+	bits.assign((uint64_t(words) * bits_per_word + 63) / 64 + 1, 0);
+}
+
+uint64_t BloomFilter::hash(const string& word)
+{
+	uint64_t h = 14695981039346656037ULL;
+	for (char ch : word)
+	{
+		h ^= (unsigned char)ch;
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+void BloomFilter::add(const string& word)
+{
+	if (bits.empty())
+		return;
+
+	uint64_t h = hash(word);
+	uint64_t h1 = h & 0xffffffff;
+	uint64_t h2 = (h >> 32) | 1;
+	uint64_t size = bits.size() * 64;
+
+	for (uint32_t i = 0; i < hashes; ++i)
+	{
+		uint64_t bit = (h1 + i * h2) % size;
+		bits[bit / 64] |= uint64_t(1) << (bit % 64);
+	}
+}
+
+bool BloomFilter::maybe_contains(const string& word) const
+{
+	// an empty filter knows nothing
+	if (bits.empty())
+		return true;
+
+	uint64_t h = hash(word);
+	uint64_t h1 = h & 0xffffffff;
+	uint64_t h2 = (h >> 32) | 1;
+	uint64_t size = bits.size() * 64;
+
+	for (uint32_t i = 0; i < hashes; ++i)
+	{
+		uint64_t bit = (h1 + i * h2) % size;
+		if (!(bits[bit / 64] & (uint64_t(1) << (bit % 64))))
+			return false;
+	}
+
+	return true;
+}
+
+// magic, hash count, number of 64-bit blocks, blocks
+string BloomFilter::serialize() const
+{
+	uint32_t blocks = bits.size();
+
+	string data(magic, sizeof magic);
+	data.append(reinterpret_cast<const char*>(&hashes), sizeof hashes);
+	data.append(reinterpret_cast<const char*>(&blocks), sizeof blocks);
+	data.append(reinterpret_cast<const char*>(bits.data()), blocks * sizeof(uint64_t));
+
+	return data;
+}
+
+bool BloomFilter::load(const char* data, size_t size)
+{
+	const size_t header = sizeof magic + 2 * sizeof(uint32_t);
+	if (size < header || std::memcmp(data, magic, sizeof magic) != 0)
+		return false;
+
+	uint32_t h;
+	uint32_t blocks;
+	std::memcpy(&h, data + sizeof magic, sizeof h);
+	std::memcpy(&blocks, data + sizeof magic + sizeof h, sizeof blocks);
+
+	if (h == 0 || blocks == 0 || (size - header) / sizeof(uint64_t) != blocks)
+		return false;
+
+	hashes = h;
+	bits.resize(blocks);
+	std::memcpy(bits.data(), data + header, blocks * sizeof(uint64_t));
+
+	return true;
+}
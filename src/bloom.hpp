@@ -0,0 +1,42 @@
+#ifndef BLOOM_HPP
+#define BLOOM_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// probabilistic set of words: no false negatives, a few false positives
+//
+// hashing is fixed so a filter built by the server can be used by clients
+class BloomFilter
+{
+	uint32_t hashes {0};
+	std::vector<uint64_t> bits;
+
+	// 64-bit FNV-1a, split in two for double hashing
+	static uint64_t hash(const std::string& word);
+public:
+	BloomFilter() {}
+	// size for the given number of words
+	BloomFilter(uint32_t words, unsigned int bits_per_word = 10);
+
+	inline bool is_empty() const
+	{
+		return bits.empty();
+	}
+
+	void add(const std::string& word);
+	// false means the word is definitely not in the set
+	bool maybe_contains(const std::string& word) const;
+
+	// serialized form, for sending to clients
+	std::string serialize() const;
+	bool load(const char* data, size_t size);
+
+	inline size_t footprint() const
+	{
+		return bits.size() * sizeof(uint64_t);
+	}
+};
+
+#endif
@@ -0,0 +1,601 @@
+#include <set>
+#include <stdexcept>
+
+#include "board.hpp"
+
+using std::array;
+using std::string;
+using std::vector;
+
+// for checking connectedness of board
+void Board::traverse(const Coord& start, vector<Coord>& reached)
+{
+	unsigned int i;
+	Chunk* chunk {occupied(start, i)};
+	if (chunk == nullptr)
+		return;
+
+	// explicit stack, long snakes of letters would overflow the call stack
+	vector<Coord> stack {start};
+	chunk->visited[i] = generation;
+	while (!stack.empty())
+	{
+		const Coord pos {stack.back()};
+		stack.pop_back();
+		reached.push_back(pos);
+
+		for (const Coord& next : {Coord {pos.x - 1, pos.y}, Coord {pos.x + 1, pos.y}, Coord {pos.x, pos.y - 1}, Coord {pos.x, pos.y + 1}})
+		{
+			chunk = occupied(next, i);
+			if (chunk != nullptr && chunk->visited[i] != generation)
+			{
+				chunk->visited[i] = generation;
+				stack.push_back(next);
+			}
+		}
+	}
+}
+
+void Board::join_components(int x, int y)
+{
+	const Coord sides[] {{x - 1, y}, {x + 1, y}, {x, y - 1}, {x, y + 1}};
+	unsigned int i;
+	Chunk* chunk;
+
+	// keep the biggest neighboring component, relabel the rest into it.
+	// letters placed in the same batch but not joined yet have no label
+	uint32_t target {0};
+	for (const auto& side : sides)
+	{
+		chunk = occupied(side, i);
+		if (chunk != nullptr && chunk->components[i] != 0 && (target == 0 || component_sizes[chunk->components[i]] > component_sizes[target]))
+			target = chunk->components[i];
+	}
+
+	if (target == 0)
+		target = next_component++;
+
+	for (const auto& side : sides)
+	{
+		chunk = occupied(side, i);
+		if (chunk == nullptr || chunk->components[i] == 0 || chunk->components[i] == target)
+			continue;
+
+		uint32_t old {chunk->components[i]};
+		component_sizes[target] += component_sizes[old];
+		component_sizes.erase(old);
+
+		vector<Coord> stack {side};
+		chunk->components[i] = target;
+		while (!stack.empty())
+		{
+			const Coord pos {stack.back()};
+			stack.pop_back();
+
+			for (const Coord& next : {Coord {pos.x - 1, pos.y}, Coord {pos.x + 1, pos.y}, Coord {pos.x, pos.y - 1}, Coord {pos.x, pos.y + 1}})
+			{
+				chunk = occupied(next, i);
+				if (chunk != nullptr && chunk->components[i] == old)
+				{
+					chunk->components[i] = target;
+					stack.push_back(next);
+				}
+			}
+		}
+	}
+
+	chunk = occupied(x, y, i);
+	chunk->components[i] = target;
+	++component_sizes[target];
+}
+
+void Board::split_components(uint32_t component, const vector<Coord>& seeds)
+{
+	// search outward from each seed in lockstep. searches that meet are in
+	// the same piece. once all but one piece has been fully explored, those
+	// are the ones that broke off, and the rest keeps the old label
+	//
+	// this stops as soon as the searches have all met, which is quick when
+	// the seeds are joined close by. it isn't when the only way between them
+	// is long: opening a loop of n letters sends two searches n / 2 each way
+	// around before they meet, so the worst case is still the whole component
+	vector<vector<Coord>> queues;
+	vector<size_t> heads;
+	vector<unsigned int> group;
+	// search that reached each cell, by position
+	std::unordered_map<uint64_t, unsigned int> seen;
+	unsigned int i;
+
+	for (const auto& seed : seeds)
+	{
+		if (seen.count(chunk_key(seed.x, seed.y)) == 0)
+		{
+			seen[chunk_key(seed.x, seed.y)] = queues.size();
+			group.push_back(queues.size());
+			queues.push_back(vector<Coord> {seed});
+			heads.push_back(0);
+		}
+	}
+	unsigned int searches = queues.size();
+
+	auto find = [&group](unsigned int s)
+	{
+		while (group[s] != s)
+			s = group[s];
+		return s;
+	};
+
+	while (true)
+	{
+		unsigned int pieces {0};
+		unsigned int unfinished {0};
+		for (unsigned int s = 0; s < searches; ++s)
+		{
+			if (find(s) != s)
+				continue;
+
+			++pieces;
+			for (unsigned int t = 0; t < searches; ++t)
+			{
+				if (find(t) == s && heads[t] < queues[t].size())
+				{
+					++unfinished;
+					break;
+				}
+			}
+		}
+
+		// still one piece
+		if (pieces <= 1)
+			return;
+		if (unfinished <= 1)
+			break;
+
+		for (unsigned int s = 0; s < searches; ++s)
+		{
+			if (heads[s] == queues[s].size())
+				continue;
+
+			const Coord pos {queues[s][heads[s]++]};
+			for (const Coord& next : {Coord {pos.x - 1, pos.y}, Coord {pos.x + 1, pos.y}, Coord {pos.x, pos.y - 1}, Coord {pos.x, pos.y + 1}})
+			{
+				if (occupied(next, i) == nullptr)
+					continue;
+
+				auto it = seen.find(chunk_key(next.x, next.y));
+				if (it == seen.end())
+				{
+					seen[chunk_key(next.x, next.y)] = s;
+					queues[s].push_back(next);
+				}
+				else if (find(it->second) != find(s))
+					group[find(it->second)] = find(s);
+			}
+		}
+	}
+
+	// the unfinished piece keeps the label, or the biggest if they all finished
+	unsigned int keep {searches};
+	std::unordered_map<unsigned int, unsigned int> sizes;
+	for (const auto& pair : seen)
+		++sizes[find(pair.second)];
+	for (unsigned int s = 0; s < searches; ++s)
+		if (heads[s] < queues[s].size())
+			keep = find(s);
+	if (keep == searches)
+		for (const auto& pair : sizes)
+			if (keep == searches || pair.second > sizes[keep])
+				keep = pair.first;
+
+	std::unordered_map<unsigned int, uint32_t> labels;
+	for (const auto& pair : sizes)
+	{
+		if (pair.first == keep)
+			continue;
+
+		labels[pair.first] = next_component;
+		component_sizes[next_component] = pair.second;
+		component_sizes[component] -= pair.second;
+		++next_component;
+	}
+
+	for (const auto& pair : seen)
+	{
+		auto it = labels.find(find(pair.second));
+		if (it != labels.end())
+		{
+			Chunk* chunk {occupied(int32_t(uint32_t(pair.first >> 32)), int32_t(uint32_t(pair.first)), i)};
+			chunk->components[i] = it->second;
+		}
+	}
+}
+
+void Board::index_word(const Coord& start, int dir)
+{
+	const int dx {dir == 0 ? 1 : 0};
+	const int dy {dir == 0 ? 0 : 1};
+	if (get(start.x, start.y) == 0 || get(start.x - dx, start.y - dy) != 0)
+		return;
+
+	string word;
+	char letter;
+	for (Coord pos {start}; (letter = get(pos.x, pos.y)) != 0; pos.x += dx, pos.y += dy)
+		word.push_back(letter);
+
+	// single letters aren't words
+	if (word.size() > 1)
+		(dir == 0 ? hwords : vwords)[start] = IndexedWord {word, ++stamp};
+}
+
+void Board::update_words(vector<Coord> cells, int dir)
+{
+	auto& index = dir == 0 ? hwords : vwords;
+	const int dx {dir == 0 ? 1 : 0};
+	const int dy {dir == 0 ? 0 : 1};
+
+	// go along each line in order, so no run is walked more than once
+	std::sort(cells.begin(), cells.end(), [dir](const Coord& a, const Coord& b)
+	{
+		return dir == 0 ? a.y < b.y || (a.y == b.y && a.x < b.x) : a < b;
+	});
+
+	// only words starting at the start of the run leading up to a cell, at
+	// the cell or just after it can have changed
+	vector<Coord> starts;
+	Coord first {0, 0};
+	for (size_t c = 0; c < cells.size(); ++c)
+	{
+		const Coord& pos {cells[c]};
+
+		// walk back to the start of the run, or to the previous cell if it's in the same run
+		Coord back {pos};
+		while (true)
+		{
+			const Coord before {back.x - dx, back.y - dy};
+			if (get(before.x, before.y) == 0)
+			{
+				first = back;
+				break;
+			}
+			if (c > 0 && before == cells[c - 1])
+				break;
+			back = before;
+		}
+
+		starts.push_back(first);
+		starts.push_back(pos);
+		starts.push_back(Coord {pos.x + dx, pos.y + dy});
+	}
+
+	std::sort(starts.begin(), starts.end());
+	starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+
+	for (const auto& start : starts)
+		index.erase(start);
+	for (const auto& start : starts)
+		index_word(start, dir);
+}
+
+void Board::mark_unchecked(const vector<Coord>& cells)
+{
+	if (check_all)
+		return;
+
+	unchecked.insert(unchecked.end(), cells.begin(), cells.end());
+	// nobody is checking, or so much changed that it's the whole board anyway
+	if (unchecked.size() > letters)
+	{
+		check_all = true;
+		unchecked.clear();
+	}
+}
+
+Coord Board::run_start(int x, int y, int dir) const
+{
+	int coord[2] {x, y};
+	do
+		coord[dir]--;
+	while (get(coord[0], coord[1]) != 0);
+	coord[dir]++;
+
+	return Coord {coord[0], coord[1]};
+}
+
+void Board::check_run(const Coord& start, int dir, const Dictionary& dictionary)
+{
+	int coord[2] {start.x, start.y};
+	string run;
+	char letter;
+	for (; (letter = get(coord[0], coord[1])) != 0; coord[dir]++)
+		run.push_back(letter);
+
+	// runs can grow at either end, so only ones that aren't part of any word
+	// are stuck. single letters aren't words, so they can't be wrong yet
+	bool dead {run.size() > 1 && !dictionary.is_factor(run)};
+	unsigned int i;
+	coord[0] = start.x;
+	coord[1] = start.y;
+	for (size_t n = 0; n < run.size(); ++n, coord[dir]++)
+	{
+		Chunk* chunk {occupied(coord[0], coord[1], i)};
+		if (dead)
+			chunk->dead_ends[i] |= 1 << dir;
+		else
+			chunk->dead_ends[i] &= ~(1 << dir);
+	}
+}
+
+void Board::update_bounds()
+{
+	if (letters == 0)
+	{
+		// reset center if all letters removed
+		min = {0, 0};
+		max = {0, 0};
+		return;
+	}
+
+	min = {columns.begin()->first, rows.begin()->first};
+	max = {columns.rbegin()->first, rows.rbegin()->first};
+}
+
+char Board::get(int x, int y, uint32_t* handle) const
+{
+	auto it = chunks.find(chunk_key(chunk_coord(x), chunk_coord(y)));
+	if (it == chunks.end())
+		return 0;
+
+	unsigned int i {chunk_index(x, y)};
+	char letter {it->second.letters[i]};
+	if (letter != 0 && handle != nullptr)
+		*handle = it->second.handles[i];
+	return letter;
+}
+
+char Board::remove(int x, int y, uint32_t* handle)
+{
+	vector<Placement> one {Placement {x, y, 0, 0}};
+	remove_many(one);
+	if (one[0].letter != 0 && handle != nullptr)
+		*handle = one[0].handle;
+	return one[0].letter;
+}
+
+char Board::place(int x, int y, char letter, uint32_t handle, uint32_t* old_handle)
+{
+	vector<Placement> one {Placement {x, y, letter, handle}};
+	place_many(one);
+	if (one[0].letter != 0 && old_handle != nullptr)
+		*old_handle = one[0].handle;
+	return one[0].letter;
+}
+
+void Board::place_many(vector<Placement>& placements)
+{
+	vector<Coord> changed;
+	vector<Coord> added;
+	for (auto& placement : placements)
+	{
+		if (placement.letter == 0)
+			throw std::runtime_error("attempt to place empty letter");
+
+		Chunk& chunk = chunks[chunk_key(chunk_coord(placement.x), chunk_coord(placement.y))];
+		unsigned int i {chunk_index(placement.x, placement.y)};
+		char old {chunk.letters[i]};
+		uint32_t old_handle {chunk.handles[i]};
+
+		chunk.letters[i] = placement.letter;
+		chunk.handles[i] = placement.handle;
+		chunk.dead_ends[i] = 0;
+
+		if (old != 0)
+			hash ^= zobrist(placement.x, placement.y, old);
+		hash ^= zobrist(placement.x, placement.y, placement.letter);
+
+		if (old == 0)
+		{
+			// labelled once the whole batch is down
+			chunk.components[i] = 0;
+			++chunk.count;
+			++letters;
+			++columns[placement.x];
+			++rows[placement.y];
+			added.push_back(Coord {placement.x, placement.y});
+		}
+
+		// the letter may have changed even if the shape didn't
+		changed.push_back(Coord {placement.x, placement.y});
+
+		placement.letter = old;
+		placement.handle = old_handle;
+	}
+
+	for (const auto& pos : added)
+		join_components(pos.x, pos.y);
+
+	update_bounds();
+
+	update_words(changed, 0);
+	update_words(changed, 1);
+	mark_unchecked(changed);
+}
+
+void Board::remove_many(vector<Placement>& placements)
+{
+	vector<Coord> changed;
+	for (auto& placement : placements)
+	{
+		auto it = chunks.find(chunk_key(chunk_coord(placement.x), chunk_coord(placement.y)));
+		unsigned int i {chunk_index(placement.x, placement.y)};
+
+		// nothing to change
+		if (it == chunks.end() || it->second.letters[i] == 0)
+		{
+			placement.letter = 0;
+			continue;
+		}
+
+		Chunk& chunk = it->second;
+		placement.letter = chunk.letters[i];
+		placement.handle = chunk.handles[i];
+		uint32_t component {chunk.components[i]};
+
+		--letters;
+		hash ^= zobrist(placement.x, placement.y, placement.letter);
+
+		// drop chunk once it is empty
+		chunk.letters[i] = 0;
+		chunk.dead_ends[i] = 0;
+		if (--chunk.count == 0)
+			chunks.erase(it);
+
+		if (--component_sizes[component] == 0)
+			component_sizes.erase(component);
+
+		if (--columns[placement.x] == 0)
+			columns.erase(placement.x);
+		if (--rows[placement.y] == 0)
+			rows.erase(placement.y);
+
+		changed.push_back(Coord {placement.x, placement.y});
+	}
+
+	// whatever is left next to removed letters may have broken off from the
+	// rest of its component
+	std::unordered_map<uint32_t, vector<Coord>> seeds;
+	unsigned int i;
+	for (const auto& pos : changed)
+	{
+		for (const Coord& side : {Coord {pos.x - 1, pos.y}, Coord {pos.x + 1, pos.y}, Coord {pos.x, pos.y - 1}, Coord {pos.x, pos.y + 1}})
+		{
+			Chunk* chunk {occupied(side, i)};
+			if (chunk != nullptr)
+				seeds[chunk->components[i]].push_back(side);
+		}
+	}
+
+	for (const auto& pair : seeds)
+		split_components(pair.first, pair.second);
+
+	update_bounds();
+
+	update_words(changed, 0);
+	update_words(changed, 1);
+	mark_unchecked(changed);
+}
+
+void Board::clear()
+{
+	chunks.clear();
+	component_sizes.clear();
+	rows.clear();
+	columns.clear();
+	letters = 0;
+	hash = 0;
+	min = {0, 0};
+	max = {0, 0};
+	hwords.clear();
+	vwords.clear();
+	unchecked.clear();
+	check_all = false;
+}
+
+unsigned int Board::find_strays(vector<Coord>& strays)
+{
+	// connectivity is kept up to date, so only search when there are strays
+	if (is_connected())
+		return 0;
+
+	// a new generation means nothing counts as visited, without resetting cells
+	++generation;
+
+	// find every group in one pass
+	vector<vector<Coord>> groups;
+	each_cell([this, &groups](const Cell& cell)
+	{
+		unsigned int i;
+		Chunk* chunk {occupied(cell.x, cell.y, i)};
+		if (chunk->visited[i] != generation)
+		{
+			groups.emplace_back();
+			traverse(Coord {cell.x, cell.y}, groups.back());
+		}
+	});
+
+	size_t largest {0};
+	for (size_t g = 1; g < groups.size(); ++g)
+		if (groups[g].size() > groups[largest].size())
+			largest = g;
+
+	for (size_t g = 0; g < groups.size(); ++g)
+		if (g != largest)
+			strays.insert(strays.end(), groups[g].begin(), groups[g].end());
+
+	return groups.size() - 1;
+}
+
+gridword_map& Board::get_words(unsigned int since)
+{
+	words.clear();
+
+	// the index is kept up to date, so just collect it
+	for (auto& pair : hwords)
+		if (pair.second.stamp > since)
+			words[pair.second.text].push_back(array<int, 3>{{pair.first.x, pair.first.y, 0}});
+	for (auto& pair : vwords)
+		if (pair.second.stamp > since)
+			words[pair.second.text].push_back(array<int, 3>{{pair.first.x, pair.first.y, 1}});
+
+	return words;
+}
+
+void Board::check_prefixes(const Dictionary& dictionary)
+{
+	if (check_all)
+	{
+		recheck_prefixes(dictionary);
+		return;
+	}
+
+	// placing a letter joins the runs on either side, so checking the run
+	// through it covers them. removing it splits them, so check both sides
+	std::set<Coord> starts[2];
+	for (const auto& cell : unchecked)
+	{
+		for (int dir = 0; dir < 2; ++dir)
+		{
+			if (get(cell.x, cell.y) != 0)
+			{
+				starts[dir].insert(run_start(cell.x, cell.y, dir));
+				continue;
+			}
+
+			for (int side : {-1, 1})
+			{
+				int coord[2] {cell.x, cell.y};
+				coord[dir] += side;
+				if (get(coord[0], coord[1]) != 0)
+					starts[dir].insert(run_start(coord[0], coord[1], dir));
+			}
+		}
+	}
+	unchecked.clear();
+
+	for (int dir = 0; dir < 2; ++dir)
+		for (const auto& start : starts[dir])
+			check_run(start, dir, dictionary);
+}
+
+void Board::recheck_prefixes(const Dictionary& dictionary)
+{
+	unchecked.clear();
+	check_all = false;
+
+	for (auto& pair : chunks)
+		pair.second.dead_ends.fill(0);
+
+	for (auto& pair : hwords)
+		check_run(pair.first, 0, dictionary);
+	for (auto& pair : vwords)
+		check_run(pair.first, 1, dictionary);
+}
@@ -0,0 +1,323 @@
+#ifndef BOARD_HPP
+#define BOARD_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dictionary.hpp"
+
+// map used for associating strings to position/direction in grid
+typedef std::map<std::string, std::vector<std::array<int, 3>>> gridword_map;
+
+struct Coord
+{
+	int x;
+	int y;
+
+	inline bool operator==(const Coord& other) const
+	{
+		return x == other.x && y == other.y;
+	}
+
+	inline bool operator!=(const Coord& other) const
+	{
+		return !(*this == other);
+	}
+
+	inline bool operator<(const Coord& other) const
+	{
+		return x < other.x || (x == other.x && y < other.y);
+	}
+};
+
+// letters on a grid, without any graphics
+//
+// keeps everything needed to judge a board up to date as letters are placed
+// and removed: words, connectivity, bounding box. the owner can tag each
+// letter with a handle, e.g. an index into its own tile storage
+class Board
+{
+public:
+	// letters are stored in square chunks, so memory and iteration follow the
+	// letters placed rather than their distance from the origin
+	static const int chunk_size {16};
+	static const unsigned int chunk_cells {chunk_size * chunk_size};
+
+	// what callbacks get to see of an occupied cell
+	struct Cell
+	{
+		int x;
+		int y;
+		char letter;
+		uint32_t handle;
+		bool dead_end; // in a run that isn't part of any word
+	};
+
+	// a letter going onto or coming off the board
+	struct Placement
+	{
+		int x;
+		int y;
+		char letter;
+		uint32_t handle;
+	};
+
+private:
+	struct Chunk
+	{
+		std::array<char, chunk_cells> letters; // 0 if empty
+		std::array<uint32_t, chunk_cells> handles;
+		std::array<uint32_t, chunk_cells> components;
+		std::array<uint32_t, chunk_cells> visited;
+		std::array<uint8_t, chunk_cells> dead_ends; // bit per direction
+		unsigned int count {0};
+
+		Chunk()
+		{
+			letters.fill(0);
+			visited.fill(0);
+			dead_ends.fill(0);
+		}
+	};
+
+	// word along with when it was last changed
+	struct IndexedWord
+	{
+		std::string text;
+		unsigned int stamp;
+	};
+
+	std::unordered_map<uint64_t, Chunk> chunks;
+	unsigned int letters {0};
+
+	Coord min {0, 0};
+	Coord max {0, 0};
+	// letters in each column and row, for keeping the bounds without rescanning
+	std::map<int, unsigned int> columns;
+	std::map<int, unsigned int> rows;
+
+	// words by starting position, kept up to date by place and remove
+	std::map<Coord, IndexedWord> hwords;
+	std::map<Coord, IndexedWord> vwords;
+	unsigned int stamp {0}; // bumped on every change to the index
+	gridword_map words;
+
+	// letters in each connected component, maintained as letters come and go
+	std::unordered_map<uint32_t, unsigned int> component_sizes;
+	uint32_t next_component {1};
+
+	// cells reached by the current search have visited == generation
+	uint32_t generation {0};
+
+	// cells changed since runs were last checked against a dictionary. once
+	// there are more than letters on the board, everything is checked instead
+	std::vector<Coord> unchecked;
+	bool check_all {false};
+
+	// xor of the keys of every letter on the board, for recognizing layouts
+	uint64_t hash {0};
+
+	// key for letter at x, y. the board has no bounds to make a table of random
+	// keys for, so they are mixed from the position and letter instead
+	static inline uint64_t zobrist(int x, int y, char letter)
+	{
+		uint64_t z {((uint64_t(uint32_t(x)) << 32) | uint32_t(y)) + uint64_t(uint8_t(letter)) * 0x9e3779b97f4a7c15ull};
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+		return z ^ (z >> 31);
+	}
+
+	// chunk containing coordinate (rounding down for negatives)
+	static inline int chunk_coord(int v)
+	{
+		return v >= 0 ? v / chunk_size : -((-v - 1) / chunk_size) - 1;
+	}
+
+	static inline uint64_t chunk_key(int cx, int cy)
+	{
+		return (uint64_t(uint32_t(cx)) << 32) | uint32_t(cy);
+	}
+
+	// slot for x, y within its chunk
+	static inline unsigned int chunk_index(int x, int y)
+	{
+		return (x - chunk_coord(x) * chunk_size) * chunk_size + (y - chunk_coord(y) * chunk_size);
+	}
+
+	// chunk holding a letter at x, y, setting index to its slot, or nullptr
+	inline Chunk* occupied(int x, int y, unsigned int& index)
+	{
+		auto it = chunks.find(chunk_key(chunk_coord(x), chunk_coord(y)));
+		if (it == chunks.end())
+			return nullptr;
+
+		index = chunk_index(x, y);
+		return it->second.letters[index] != 0 ? &it->second : nullptr;
+	}
+
+	inline Chunk* occupied(const Coord& pos, unsigned int& index)
+	{
+		return occupied(pos.x, pos.y, index);
+	}
+
+	// call f for the occupied part of chunk at cx, cy within the given bounds
+	template<typename F> inline static void visit(int cx, int cy, const Chunk& chunk, int left, int top, int right, int bottom, F& f)
+	{
+		int x0 {std::max(left, cx * chunk_size)};
+		int x1 {std::min(right, cx * chunk_size + chunk_size - 1)};
+		int y0 {std::max(top, cy * chunk_size)};
+		int y1 {std::min(bottom, cy * chunk_size + chunk_size - 1)};
+		for (int x = x0; x <= x1; ++x)
+		{
+			for (int y = y0; y <= y1; ++y)
+			{
+				unsigned int i {chunk_index(x, y)};
+				if (chunk.letters[i] != 0)
+					f(Cell {x, y, chunk.letters[i], chunk.handles[i], chunk.dead_ends[i] != 0});
+			}
+		}
+	}
+
+	// add start and every letter connected to it to reached
+	void traverse(const Coord& start, std::vector<Coord>& reached);
+	// set min and max from occupied columns and rows
+	void update_bounds();
+	// add word starting at start, oriented in dir, to the index
+	void index_word(const Coord& start, int dir);
+	// reindex words oriented in dir through and next to the given cells
+	void update_words(std::vector<Coord> cells, int dir);
+	// label letter placed at x, y, merging any components it touches
+	void join_components(int x, int y);
+	// relabel whatever broke off component when letters next to seeds were removed
+	void split_components(uint32_t component, const std::vector<Coord>& seeds);
+	// remember cells changed by a batch until runs are next checked
+	void mark_unchecked(const std::vector<Coord>& cells);
+	// first cell of the run through x, y oriented in dir, which must be occupied
+	Coord run_start(int x, int y, int dir) const;
+	// mark run starting at start oriented in dir if it isn't part of any word
+	void check_run(const Coord& start, int dir, const Dictionary& dictionary);
+public:
+	// letter at x, y, or 0 if empty. handle is set if there is a letter
+	char get(int x, int y, uint32_t* handle = nullptr) const;
+	// put letter at x, y, returning the letter that was there or 0.
+	// old_handle is set to the replaced letter's handle
+	char place(int x, int y, char letter, uint32_t handle = 0, uint32_t* old_handle = nullptr);
+	// remove letter at x, y, returning it or 0. handle is set if there was one
+	char remove(int x, int y, uint32_t* handle = nullptr);
+	// put letters down together, updating words, bounds and connectivity once
+	// for the lot. each placement is set to the letter and handle it replaced,
+	// letter 0 if the cell was empty
+	void place_many(std::vector<Placement>& placements);
+	// remove letters at the placements' positions together. each placement is
+	// set to the letter and handle removed, letter 0 if the cell was empty
+	void remove_many(std::vector<Placement>& placements);
+	// remove all letters
+	void clear();
+
+	inline unsigned int size() const
+	{
+		return letters;
+	}
+
+	// same letters in the same places give the same hash, however they got there
+	inline uint64_t get_hash() const
+	{
+		return hash;
+	}
+
+	inline const Coord& get_min() const
+	{
+		return min;
+	}
+
+	inline const Coord& get_max() const
+	{
+		return max;
+	}
+
+	// call f with every occupied cell, in no particular order
+	template<typename F> inline void each_cell(F f) const
+	{
+		for (const auto& pair : chunks)
+		{
+			int cx {int32_t(uint32_t(pair.first >> 32))};
+			int cy {int32_t(uint32_t(pair.first))};
+			visit(cx, cy, pair.second, cx * chunk_size, cy * chunk_size, cx * chunk_size + chunk_size - 1, cy * chunk_size + chunk_size - 1, f);
+		}
+	}
+
+	// call f with every occupied cell with left <= x < left + width and top <= y < top + height
+	template<typename F> inline void each_cell_in(int left, int top, int width, int height, F f) const
+	{
+		if (width <= 0 || height <= 0)
+			return;
+
+		int right {left + width - 1};
+		int bottom {top + height - 1};
+		int cleft {chunk_coord(left)};
+		int ctop {chunk_coord(top)};
+		int cright {chunk_coord(right)};
+		int cbottom {chunk_coord(bottom)};
+
+		// look chunks up by position, or filter the ones we have if that's fewer
+		if (uint64_t(cright - cleft + 1) * uint64_t(cbottom - ctop + 1) <= chunks.size())
+		{
+			for (int cx = cleft; cx <= cright; ++cx)
+			{
+				for (int cy = ctop; cy <= cbottom; ++cy)
+				{
+					auto it = chunks.find(chunk_key(cx, cy));
+					if (it != chunks.end())
+						visit(cx, cy, it->second, left, top, right, bottom, f);
+				}
+			}
+		}
+		else
+		{
+			for (const auto& pair : chunks)
+			{
+				int cx {int32_t(uint32_t(pair.first >> 32))};
+				int cy {int32_t(uint32_t(pair.first))};
+				if (cx >= cleft && cx <= cright && cy >= ctop && cy <= cbottom)
+					visit(cx, cy, pair.second, left, top, right, bottom, f);
+			}
+		}
+	}
+
+	// whether all letters are connected, in constant time
+	inline bool is_connected() const
+	{
+		return component_sizes.size() <= 1;
+	}
+
+	// need at least one word for a valid board
+	inline bool has_words() const
+	{
+		return !hwords.empty() || !vwords.empty();
+	}
+
+	// find cells cut off from the largest group, returning how many groups they make up
+	unsigned int find_strays(std::vector<Coord>& strays);
+
+	// for telling which words changed since some point
+	inline unsigned int get_stamp() const
+	{
+		return stamp;
+	}
+
+	// get map of words to vector of position/direction triplets
+	// only words changed after since, if given
+	gridword_map& get_words(unsigned int since = 0);
+
+	// flag runs that aren't part of any word, among those changed since the last check
+	void check_prefixes(const Dictionary& dictionary);
+	// flag runs that aren't part of any word, anywhere on the board, e.g. for a new dictionary
+	void recheck_prefixes(const Dictionary& dictionary);
+};
+
+#endif
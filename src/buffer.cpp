@@ -6,37 +6,35 @@ CutBuffer::CutBuffer(Grid& grid, int left, int top, const sf::Vector2u& sz)
 	sf::Vector2i max {left, top};
 
 	// try to shrink selection
-	for (int i = left; i < left + (int)sz.x; i++)
-		for (int j = top; j < top + (int)sz.y; j++)
-		{
-			auto tile = grid.get(i, j);
-			if (tile != nullptr)
-			{
-				if (i < min.x)
-					min.x = i;
-				if (i > max.x)
-					max.x = i;
-				if (j < min.y)
-					min.y = j;
-				if (j > max.y)
-					max.y = j;
-			}
-		}
+	std::vector<sf::Vector2i> found;
+	grid.get_board().each_cell_in(left, top, sz.x, sz.y, [&](const Board::Cell& cell)
+	{
+		const sf::Vector2i p {cell.x, cell.y};
+		if (p.x < min.x)
+			min.x = p.x;
+		if (p.x > max.x)
+			max.x = p.x;
+		if (p.y < min.y)
+			min.y = p.y;
+		if (p.y > max.y)
+			max.y = p.y;
+		found.push_back(p);
+	});
 
 	// if nonempty
-	if (min.x <= max.x && min.y <= max.y)
+	if (!found.empty())
 	{
 		size = max - min + XY;
 		pos = (max + min) / 2;
 
-		for (int i = min.x; i <= max.x; i++)
-			for (int j = min.y; j <= max.y; j++)
-			{
-				Tile* tile = grid.remove(i, j);
-				if (tile != nullptr)
-					tile->set_color(sf::Color(255, 255, 255, 100));
-				tiles.push_back(tile);
-			}
+		tiles.assign(size.x * size.y, nullptr);
+		std::vector<Tile*> removed {grid.remove_many(found)};
+		for (unsigned int i = 0; i < found.size(); i++)
+		{
+			const sf::Vector2i& p {found[i]};
+			removed[i]->set_color(sf::Color(255, 255, 255, 100));
+			tiles[(p.x - min.x) * size.y + (p.y - min.y)] = removed[i];
+		}
 	}
 }
 
@@ -64,6 +62,7 @@ void CutBuffer::transpose()
 // put tiles back in grid, returning displaced tiles to hand
 void CutBuffer::paste(Grid& grid, Hand& hand)
 {
+	std::vector<std::pair<sf::Vector2i, Tile*>> placed;
 	for (int i = 0; i < size.x; i++)
 		for (int j = 0; j < size.y; j++)
 		{
@@ -71,13 +70,14 @@ void CutBuffer::paste(Grid& grid, Hand& hand)
 			if (tile != nullptr)
 			{
 				tile->set_color(sf::Color::White);
-
-				Tile* r = grid.swap(sf::Vector2i(i, j) + pos - size / 2, tile);
-				if (r != nullptr)
-					hand.add_tile(r);
+				placed.push_back(std::make_pair(sf::Vector2i(i, j) + pos - size / 2, tile));
 			}
 		}
 
+	// all at once, so words are only worked out once
+	for (auto tile : grid.place_many(placed))
+		hand.add_tile(tile);
+
 	tiles.clear();
 }
 
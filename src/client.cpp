@@ -86,6 +86,7 @@ void Client::load(std::ifstream& save_file)
 	}
 
 	// read grid
+	std::vector<std::pair<sf::Vector2i, Tile*>> placed;
 	save_file.get(ch);
 	while (!save_file.eof())
 	{
@@ -93,15 +94,21 @@ void Client::load(std::ifstream& save_file)
 		save_file.read(reinterpret_cast<char*>(&pos.x), sizeof pos.x);
 		save_file.read(reinterpret_cast<char*>(&pos.y), sizeof pos.y);
 
-		grid.swap(pos, new Tile(ch));
+		placed.push_back(std::make_pair(pos, new Tile(ch)));
 
 		save_file.get(ch);
 	}
 
+	// a good save has no duplicates, but don't leak them if there are
+	for (auto tile : grid.place_many(placed))
+		delete tile;
+
 	// reset file
 	save_file.clear();
 	save_file.seekg(0);
 
+	check_prefixes();
+
 	// TODO this isn't necessarily true, we need more networking logic to
 	// ensure that we have a server connection without a split
 	// something like sv_connected
@@ -194,6 +201,8 @@ void Client::quick_place()
 
 		if (tile != nullptr)
 			hand.add_tile(tile);
+
+		check_prefixes();
 	}
 }
 
@@ -210,6 +219,8 @@ void Client::cut()
 				messages.add("Nothing selected.", Message::Severity::LOW);
 				clear_buffer();
 			}
+			else
+				check_prefixes();
 		}
 		else
 			messages.add("Nothing selected.", Message::Severity::LOW);
@@ -236,6 +247,7 @@ void Client::paste()
 	{
 		buffer->paste(grid, hand);
 		clear_buffer();
+		check_prefixes();
 	}
 	else
 		messages.add("Cannot paste: no tiles were cut.", Message::Severity::LOW);
@@ -246,7 +258,10 @@ void Client::remove_at_mouse()
 	// remove tile
 	Tile* tile {grid.remove(mcursor.get_pos())};
 	if (tile != nullptr)
+	{
 		hand.add_tile(tile);
+		check_prefixes();
+	}
 }
 
 void Client::prompt_show()
@@ -282,21 +297,21 @@ void Client::remove()
 		last_place -= Y;
 	}
 	// else if you are not near the last character and the space is empty, try to autoadvance
-	else if (grid.get(pos) == nullptr)
+	else if (grid.get(pos) == 0)
 	{
 		sf::Vector2i next {0, 0};
 
 		// if right of a tile
-		if (grid.get(pos - X) != nullptr)
+		if (grid.get(pos - X) != 0)
 			next = X;
 		// if below a tile
-		else if (grid.get(pos - Y) != nullptr)
+		else if (grid.get(pos - Y) != 0)
 			next = Y;
 		// if left of a tile
-		else if (grid.get(pos + X) != nullptr)
+		else if (grid.get(pos + X) != 0)
 			next = X;
 		// if above a tile
-		else if (grid.get(pos + Y) != nullptr)
+		else if (grid.get(pos + Y) != 0)
 			next = Y;
 		else
 			next = last_move;
@@ -312,7 +327,10 @@ void Client::remove()
 
 	Tile* tile {grid.remove(cursor.get_pos())};
 	if (tile != nullptr)
+	{
 		hand.add_tile(tile);
+		check_prefixes();
+	}
 }
 
 void Client::place(char ch)
@@ -320,7 +338,7 @@ void Client::place(char ch)
 	bool placed {false};
 
 	// if space is empty or has a different letter
-	if (grid.get(cursor.get_pos()) == nullptr || grid.get(cursor.get_pos())->ch() != ch)
+	if (grid.get(cursor.get_pos()) != ch)
 	{
 		if (hand.has_any(ch))
 		{
@@ -329,6 +347,8 @@ void Client::place(char ch)
 			if (tile != nullptr)
 				hand.add_tile(tile);
 			placed = true;
+
+			check_prefixes();
 		}
 	}
 	else // space already has the letter to be placed
@@ -342,13 +362,13 @@ void Client::place(char ch)
 			next.x = 1;
 		else if (cursor.get_pos() == last_place + Y)
 			next.y = 1;
-		else if (grid.get(cursor.get_pos() - X) != nullptr)
+		else if (grid.get(cursor.get_pos() - X) != 0)
 			next.x = 1;
-		else if (grid.get(cursor.get_pos() - Y) != nullptr)
+		else if (grid.get(cursor.get_pos() - Y) != 0)
 			next.y = 1;
-		else if (grid.get(cursor.get_pos() + X) != nullptr)
+		else if (grid.get(cursor.get_pos() + X) != 0)
 			next.x = 1;
-		else if (grid.get(cursor.get_pos() + Y) != nullptr)
+		else if (grid.get(cursor.get_pos() + Y) != 0)
 			next.y = 1;
 		else
 			next = last_move;
@@ -433,6 +453,9 @@ void Client::step(float time)
 	grid.step(time);
 	messages.step(time);
 
+	// cursor turns orange while the grid is in pieces
+	cursor.set_outline_color(grid.is_connected() ? sf::Color {0, 200, 0} : sf::Color {230, 140, 0});
+
 	// process incoming packets
 	sf::Packet packet;
 	sf::IpAddress ip;
@@ -509,6 +532,12 @@ void Client::ready()
 {
 	if (connected)
 	{
+		if (pending_type == cl_dict)
+		{
+			messages.add("Still downloading the dictionary. Try again in a moment.", Message::Severity::LOW);
+			return;
+		}
+
 		if (!playing)
 		{
 			// there's no point unreadying in SP
@@ -561,6 +590,8 @@ void Client::process_packet(sf::Packet& packet)
 
 				if (is_sp)
 					ready();
+				else // see if we can check words ourselves
+					request_dict(0);
 			}
 
 			string uuid;
@@ -689,39 +720,109 @@ void Client::process_packet(sf::Packet& packet)
 		}
 		case sv_check:
 		{
-			string word;
-			bool valid;
-			packet >> word >> valid;
+			sf::Int16 got_check;
+			sf::Uint16 count;
+			packet >> got_check >> count;
 
-			cerr << word << " is " << (valid? "" : "not ") << "valid\n";
+			// if this is the batch we requested
+			if (pending_type == cl_check && got_check == check_n && count == check_words.size())
+			{
+				sf::Uint8 valid {0};
+				for (unsigned int i = 0; i < count; ++i)
+				{
+					if (i % 8 == 0)
+						packet >> valid;
 
-			dictionary[word] = valid;
+					const string& word = check_words[i];
+					bool is_valid = (valid >> (i % 8)) & 1;
 
-			// if this is the word we requested
-			if (pending_type == cl_check && lookup_words.size() > 0 && lookup_words.begin()->first == word)
-			{
-				if (!valid)
-					bad_words[word] = lookup_words[word];
+					cerr << word << " is " << (is_valid ? "" : "not ") << "valid\n";
 
-				lookup_words.erase(word);
+					dictionary[word] = is_valid;
 
-				if (lookup_words.size() > 0)
-				{
-					// TODO DRY off
-					gridword_map::iterator next_word = lookup_words.begin();
-					cerr << "Requesting lookup of " << next_word->first << endl;
-					set_pending(cl_check);
-					(*pending) << next_word->first;
+					if (!is_valid)
+						bad_words[word] = lookup_words[word];
 
-					send_pending();
+					lookup_words.erase(word);
 				}
+
+				// remember answers for next time
+				if (!cache_filename.empty())
+				{
+					std::ofstream cache(cache_filename, std::ios::app);
+					for (const auto& word : check_words)
+						cache << word << ' ' << dictionary[word] << '\n';
+				}
+
+				check_words.clear();
+
+				if (lookup_words.size() > 0)
+					request_check();
 				else
 				{
 					clear_pending(true);
 					resolve_peel();
 				}
 			}
+			else if (pending_type == cl_check)
+				cerr << "Got check " << (int)got_check << " but expected " << (int)check_n << endl;
+
+			break;
+		}
+		case sv_dict:
+		{
+			sf::Uint32 checksum_high;
+			sf::Uint32 checksum_low;
+			sf::Uint8 kind;
+			sf::Uint32 chunk;
+			sf::Uint32 chunks;
+			packet >> checksum_high >> checksum_low >> kind >> chunk >> chunks;
+
+			if (pending_type != cl_dict || chunk != dict_chunk)
+				break;
+
+			if (cache_filename.empty())
+				load_cache((uint64_t(checksum_high) << 32) | checksum_low);
+
+			// server doesn't share its dictionary
+			if (kind == 0 || chunks == 0)
+			{
+				clear_pending();
+				break;
+			}
+
+			string data;
+			packet >> data;
+			dict_image.append(data);
+
+			if (chunk + 1 < chunks)
+			{
+				request_dict(chunk + 1);
+				break;
+			}
+
+			clear_pending();
+
+			if (kind == 1)
+			{
+				std::shared_ptr<Dictionary> received {new Dictionary()};
+				if (received->load_memory(dict_image.data(), dict_image.size()))
+				{
+					set_dictionary(received);
+					messages.add("Received dictionary (" + std::to_string(received->size()) + " words)", Message::Severity::LOW);
+				}
+				else
+					cerr << "Received invalid dictionary image\n";
+			}
+			else if (kind == 2)
+			{
+				if (!bloom.load(dict_image.data(), dict_image.size()))
+					cerr << "Received invalid bloom filter\n";
+			}
+			else
+				cerr << "Received unknown dictionary kind " << (int)kind << endl;
 
+			dict_image.clear();
 			break;
 		}
 		case sv_peel:
@@ -921,6 +1022,10 @@ bool Client::resolve_peel()
 	}
 
 
+	// everything up to the start of this check was fine
+	checked_stamp = peel_stamp;
+	good_layouts.insert(peel_hash);
+
 	sf::Int16 next_peel = peel_n + 1;
 
 	cerr << "No incorrect words. Requesting peel " << (int)next_peel << endl;
@@ -952,9 +1057,16 @@ bool Client::peel()
 		return false;
 	}
 
-	if (!grid.is_continuous())
+	// a layout that passed before passes again, no need to check it
+	bool known_good {good_layouts.count(grid.get_hash()) > 0};
+
+	unsigned int strays;
+	if (!known_good && !grid.is_continuous(&strays))
 	{
-		messages.add("Your tiles are not all connected.", Message::Severity::HIGH);
+		if (strays > 0)
+			messages.add("Your tiles are not all connected (" + std::to_string(strays) + " stray group" + (strays == 1 ? "" : "s") + ").", Message::Severity::HIGH);
+		else
+			messages.add("Your tiles are not all connected.", Message::Severity::HIGH);
 		return false;
 	}
 
@@ -965,33 +1077,125 @@ bool Client::peel()
 		return false;
 	}
 
-	const gridword_map& words {grid.get_words()};
+	peel_hash = grid.get_hash();
+	peel_stamp = grid.get_stamp();
+	if (known_good)
+		return resolve_peel();
+
+	// only words changed since the last good check can be wrong
+	const gridword_map& words {grid.get_words(checked_stamp)};
 	std::map<string, bool>::iterator it;
 
+	// check words ourselves if we can
+	if (local_dictionary)
+	{
+		for (auto& word : words)
+			if (!local_dictionary->check_word(word.first))
+				bad_words[word.first] = word.second;
+
+		return resolve_peel();
+	}
+
 	// check words
 	for (auto& word : words)
 	{
-		if ((it = dictionary.find(word.first)) == dictionary.end())
-			lookup_words[word.first] = word.second;
-		else if (!it->second)
+		if ((it = dictionary.find(word.first)) != dictionary.end())
+		{
+			if (!it->second)
+				bad_words[word.first] = word.second;
+		}
+		// definitely not a word, no need to ask
+		else if (!bloom.maybe_contains(word.first))
+		{
+			dictionary[word.first] = false;
 			bad_words[word.first] = word.second;
+		}
+		else
+			lookup_words[word.first] = word.second;
 	}
 
-	// all words are in local dictionary
-	if (lookup_words.size() == 0)
+	// all words are in local dictionary, or we already know the peel will fail
+	if (lookup_words.size() == 0 || bad_words.size() > 0)
+	{
+		lookup_words.clear();
 		return resolve_peel();
+	}
 
 	// need to request lookups
-	gridword_map::iterator next_word = lookup_words.begin();
-	cerr << "Requesting lookup of " << next_word->first << endl;
+	request_check();
+
+	waiting = true;
+
+	return false;
+}
+
+void Client::load_cache(uint64_t checksum)
+{
+	std::stringstream name;
+	name << "words-" << std::hex << checksum << ".cache";
+	cache_filename = name.str();
+
+	std::ifstream cache(cache_filename);
+	string word;
+	bool valid;
+	while (cache >> word >> valid)
+		dictionary[word] = valid;
+
+	cerr << "Loaded " << dictionary.size() << " words from " << cache_filename << endl;
+}
+
+void Client::request_dict(sf::Uint32 chunk)
+{
+	if (chunk == 0)
+		dict_image.clear();
+
+	dict_chunk = chunk;
+	set_pending(cl_dict);
+	(*pending) << chunk;
+	send_pending();
+}
+
+void Client::request_check()
+{
 	set_pending(cl_check);
-	(*pending) << next_word->first;
+
+	// fit as many words as we can in one packet
+	check_words.clear();
+	size_t size = 0;
+	for (const auto& word : lookup_words)
+	{
+		// each string is sent with its length
+		size_t word_size = sizeof(sf::Uint32) + word.first.size();
+		if (check_words.size() > 0 && size + word_size > max_check_size)
+			break;
+
+		check_words.push_back(word.first);
+		size += word_size;
+	}
+
+	cerr << "Requesting lookup of " << check_words.size() << " words\n";
+
+	(*pending) << ++check_n << sf::Uint16(check_words.size());
+	for (const auto& word : check_words)
+		(*pending) << word;
 
 	send_pending();
+}
 
-	waiting = true;
+void Client::set_dictionary(const std::shared_ptr<const Dictionary>& dict)
+{
+	local_dictionary = dict;
+	// another dictionary may judge words and layouts differently
+	checked_stamp = 0;
+	good_layouts.clear();
+	if (local_dictionary)
+		grid.recheck_prefixes(*local_dictionary);
+}
 
-	return false;
+void Client::check_prefixes()
+{
+	if (local_dictionary)
+		grid.check_prefixes(*local_dictionary);
 }
 
 void Client::disconnect()
@@ -1028,16 +1232,12 @@ void Client::save(const std::string& filename, const Server& server) const
 	save_file.put('\0');
 
 	// save grid
-	for (Tile* tile : grid.internal())
+	grid.get_board().each_cell([&save_file](const Board::Cell& cell)
 	{
-		if (tile != nullptr)
-		{
-			auto pos = tile->get_grid_pos();
-			save_file.put(tile->ch());
-			save_file.write(reinterpret_cast<const char*>(&pos.x), sizeof pos.x);
-			save_file.write(reinterpret_cast<const char*>(&pos.y), sizeof pos.y);
-		}
-	}
+		save_file.put(cell.letter);
+		save_file.write(reinterpret_cast<const char*>(&cell.x), sizeof cell.x);
+		save_file.write(reinterpret_cast<const char*>(&cell.y), sizeof cell.y);
+	});
 
 	save_file.close();
 }
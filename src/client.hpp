@@ -6,6 +6,7 @@
 #include <random>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
@@ -13,8 +14,10 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/Network.hpp>
 
+#include "bloom.hpp"
 #include "buffer.hpp"
 #include "cursor.hpp"
+#include "dictionary.hpp"
 #include "player.hpp"
 #include "message.hpp" // TODO remove?
 #include "server.hpp"
@@ -42,6 +45,7 @@ class Client
 	// networking
 	gridword_map lookup_words;
 	gridword_map bad_words;
+	std::vector<std::string> check_words; // words in last cl_check, in order
 
 	sf::UdpSocket socket;
 	sf::IpAddress server_ip;
@@ -57,9 +61,22 @@ class Client
 	bool is_ready = false;
 	bool waiting = false;
 	sf::Int16 peel_n {-1};
+	// grid words up to checked_stamp are known to be good, peel_stamp is where the current check started
+	unsigned int checked_stamp {0};
+	unsigned int peel_stamp {0};
+	// hashes of layouts that were connected with all good words, and of the one being checked
+	std::unordered_set<uint64_t> good_layouts;
+	uint64_t peel_hash {0};
 	std::map<std::string, bool> dictionary;
+	std::string cache_filename; // where to remember looked up words
+	// full dictionary or bloom filter, if the server sent one
+	std::shared_ptr<const Dictionary> local_dictionary;
+	BloomFilter bloom;
+	std::string dict_image; // received so far
+	sf::Uint32 dict_chunk {0};
 
 	sf::Int16 dump_n {-1};
+	sf::Int16 check_n {-1};
 
 	sf::Packet* pending = nullptr;
 	sf::Uint8 pending_type = 255;
@@ -150,6 +167,22 @@ public:
 
 	void disconnect();
 
+	// use dictionary for checking words locally, e.g. the single player server's
+	void set_dictionary(const std::shared_ptr<const Dictionary>& dict);
+
+	inline bool has_dictionary() const
+	{
+		return bool(local_dictionary);
+	}
+	// tint runs changed since the last check that aren't part of any word, if we have a dictionary
+	void check_prefixes();
+
+	// read remembered words for dictionary with the given checksum
+	void load_cache(uint64_t checksum);
+	// ask server for a piece of its dictionary
+	void request_dict(sf::Uint32 chunk);
+	// send next batch of lookup_words to the server
+	void request_check();
 	bool resolve_peel();
 
 	void process_packet(sf::Packet& packet);
@@ -291,7 +291,7 @@ int main()
 
 	Menu sp_menu {font, menu_system, &main_menu, "SOLITAIRE"};
 	Entry      start_sp   {font, "START GAME"};
-	TextEntry  dict_entry {font, "DICTIONARY", PPB * 8, "dictionary.txt", "(default dictionary)"};
+	TextEntry  dict_entry {font, "DICTIONARY", PPB * 8, "", "(default dictionary)"};
 	MultiEntry multiplier {font, "BUNCH x", {"1/2", "1", "2", "3", "4", "Infinite"}, 1};
 	sp_menu.entry(&start_sp);
 	sp_menu.entry(&dict_entry);
@@ -376,6 +376,7 @@ int main()
 
 		client = new Client(gui_view, font);
 		client->load(save_file);
+		client->set_dictionary(server->get_dictionary());
 
 		save_file.close();
 	}
@@ -487,6 +488,7 @@ int main()
 				selected = true;
 
 				delete server;
+				server = nullptr;
 				delete client;
 
 				std::string ip {server_ip.get_string()};
@@ -542,6 +544,11 @@ int main()
 
 		if (client != nullptr)
 		{
+			// the server loads the dictionary in its own thread, so pick up
+			// the same copy for checking words as they are typed once it's done
+			if (server != nullptr && !client->has_dictionary() && server->get_status() == Server::Status::RUNNING)
+				client->set_dictionary(server->get_dictionary());
+
 			if (client->game_started())
 				sound.play("audio/split.wav");
 
@@ -11,7 +11,9 @@ static const sf::Vector2i ZERO {0, 0};
 
 // networking
 static const unsigned short default_server_port {57198}; // client port is server port + 1
-static const sf::Uint8 protocol_version {0};
+static const sf::Uint8 protocol_version {1};
+static const unsigned int max_check_size {1024}; // bytes of words to send per cl_check
+static const unsigned int dict_chunk_size {16384}; // bytes of dictionary image per sv_dict
 
 // packet types
 static const sf::Uint8 cl_connect    {0};
@@ -21,6 +23,7 @@ static const sf::Uint8 cl_check      {3};
 static const sf::Uint8 cl_dump       {4};
 static const sf::Uint8 cl_peel       {5};
 static const sf::Uint8 cl_ack        {6};
+static const sf::Uint8 cl_dict       {7};
 
 static const sf::Uint8 sv_disconnect {0};
 static const sf::Uint8 sv_info       {1};
@@ -28,5 +31,6 @@ static const sf::Uint8 sv_check      {2};
 static const sf::Uint8 sv_dump       {3};
 static const sf::Uint8 sv_peel       {4};
 static const sf::Uint8 sv_done       {5};
+static const sf::Uint8 sv_dict       {6};
 
 #endif
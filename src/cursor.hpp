@@ -40,6 +40,11 @@ public:
 
 	void set_zoom(float zoom);
 
+	inline void set_outline_color(const sf::Color& color)
+	{
+		cursor.setOutlineColor(color);
+	}
+
 	inline void draw_on(sf::RenderWindow& window) const
 	{
 		window.draw(cursor);
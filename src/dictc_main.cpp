@@ -0,0 +1,73 @@
+#include <iostream>
+#include <string>
+
+#include <boost/program_options.hpp>
+
+#include "dictionary.hpp"
+
+namespace po = boost::program_options;
+using std::cout;
+using std::cerr;
+using std::endl;
+using std::string;
+
+int main(int argc, char* argv[])
+{
+	// command line arguments
+	po::options_description desc("Bananagrams dictionary compiler options");
+	desc.add_options()
+		("help",                                    "show options")
+		("input",  po::value<string>()->required(), "word list (e.g. words.txt or dictionary.txt)")
+		("output", po::value<string>()->required(), "binary dictionary image to write")
+		("embed",  po::value<string>(),             "write C++ source defining the image as a byte array with this name instead")
+	;
+
+	po::positional_options_description pos;
+	pos.add("input", 1);
+	pos.add("output", 1);
+
+	po::variables_map opts;
+
+	try
+	{
+		po::store(po::command_line_parser(argc, argv).options(desc).positional(pos).run(), opts);
+
+		if (opts.count("help"))
+		{
+			cerr << desc << endl;
+			return 1;
+		}
+
+		po::notify(opts);
+	}
+	catch (po::error& e)
+	{
+		cerr << "Error: " << e.what() << endl << endl << desc << endl;
+		return 1;
+	}
+
+	string input = opts["input"].as<string>();
+	string output = opts["output"].as<string>();
+
+	Dictionary dictionary;
+	if (!dictionary.load(input))
+	{
+		cerr << "Error: couldn't read dictionary " << input << endl;
+		return 1;
+	}
+
+	bool saved;
+	if (opts.count("embed"))
+		saved = dictionary.save_source(output, opts["embed"].as<string>());
+	else
+		saved = dictionary.save(output);
+
+	if (!saved)
+	{
+		cerr << "Error: couldn't write " << output << endl;
+		return 1;
+	}
+
+	cout << "Compiled " << dictionary.size() << " words (" << dictionary.footprint() / 1024 << " KiB) into " << output << endl;
+	return 0;
+}
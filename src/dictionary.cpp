@@ -0,0 +1,856 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#ifndef __MINGW32__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "dictionary.hpp"
+#include "packed_words.hpp"
+
+using std::string;
+using std::vector;
+
+// incremental construction of a minimal DAWG from sorted words (Daciuk et al.)
+class DawgBuilder
+{
+	struct Node
+	{
+		bool terminal {false};
+		vector<std::pair<uint8_t, uint32_t>> children; // letter, node
+	};
+
+	vector<Node> nodes;
+	vector<uint32_t> free_nodes; // nodes merged away, ready for reuse
+	std::unordered_map<string, uint32_t> registry; // minimized nodes by signature
+	vector<uint32_t> path; // nodes for previous word, path[0] is root
+	string previous;
+
+	uint32_t new_node()
+	{
+		if (free_nodes.empty())
+		{
+			nodes.push_back(Node());
+			return nodes.size() - 1;
+		}
+
+		uint32_t n = free_nodes.back();
+		free_nodes.pop_back();
+		nodes[n] = Node();
+		return n;
+	}
+
+	// children are already minimized, so their ids identify them
+	string signature(const Node& node) const
+	{
+		string sig(1, node.terminal ? '1' : '0');
+		for (const auto& child : node.children)
+		{
+			sig.push_back(child.first);
+			sig.append(reinterpret_cast<const char*>(&child.second), sizeof child.second);
+		}
+		return sig;
+	}
+
+	// replace nodes on path below depth with registered equivalents
+	void minimize(size_t depth)
+	{
+		while (path.size() > depth + 1)
+		{
+			uint32_t child = path.back();
+			path.pop_back();
+
+			string sig {signature(nodes[child])};
+			auto it = registry.find(sig);
+			if (it == registry.end())
+				registry[sig] = child;
+			else
+			{
+				nodes[path.back()].children.back().second = it->second;
+				free_nodes.push_back(child);
+			}
+		}
+	}
+public:
+	DawgBuilder()
+	{
+		path.push_back(new_node());
+	}
+
+	void add(const string& word)
+	{
+		size_t common = 0;
+		while (common < word.size() && common < previous.size() && word[common] == previous[common])
+			++common;
+
+		minimize(common);
+
+		for (size_t i = common; i < word.size(); ++i)
+		{
+			uint32_t child = new_node();
+			nodes[path.back()].children.push_back(std::make_pair(uint8_t(word[i] - 'A'), child));
+			path.push_back(child);
+		}
+		nodes[path.back()].terminal = true;
+
+		previous = word;
+	}
+
+	// minimize remaining nodes and lay out edges
+	void finish(vector<uint32_t>& edges, uint32_t terminal_bit, uint32_t last_bit, unsigned int child_shift)
+	{
+		minimize(0);
+
+		edges.clear();
+
+		// first edge of each node's run
+		vector<uint32_t> first(nodes.size(), 0);
+		vector<uint32_t> queue {path[0]};
+
+		// assign positions breadth first, root at 0
+		uint32_t next = 0;
+		for (size_t i = 0; i < queue.size(); ++i)
+		{
+			const Node& node = nodes[queue[i]];
+			first[queue[i]] = next;
+			next += node.children.size();
+
+			for (const auto& child : node.children)
+			{
+				if (!nodes[child.second].children.empty() && first[child.second] == 0)
+				{
+					// mark as queued
+					first[child.second] = 1;
+					queue.push_back(child.second);
+				}
+			}
+		}
+
+		edges.reserve(next);
+		for (auto n : queue)
+		{
+			const Node& node = nodes[n];
+			for (size_t i = 0; i < node.children.size(); ++i)
+			{
+				const Node& child = nodes[node.children[i].second];
+				uint32_t edge = node.children[i].first;
+				if (child.terminal)
+					edge |= terminal_bit;
+				if (i + 1 == node.children.size())
+					edge |= last_bit;
+				if (!child.children.empty())
+					edge |= first[node.children[i].second] << child_shift;
+				edges.push_back(edge);
+			}
+		}
+	}
+};
+
+const uint32_t Dictionary::version;
+const uint32_t Dictionary::no_word;
+
+static const char magic[4] {'B', 'G', 'D', 'W'};
+static const char definitions_magic[4] {'B', 'G', 'D', 'F'};
+
+// definitions blob: magic, word count, count + 1 offsets into the text that follows
+static void write_definitions(std::ofstream& file, const vector<string>& definitions)
+{
+	uint32_t count = definitions.size();
+	file.write(definitions_magic, sizeof definitions_magic);
+	file.write(reinterpret_cast<const char*>(&count), sizeof count);
+
+	uint32_t offset = 0;
+	file.write(reinterpret_cast<const char*>(&offset), sizeof offset);
+	for (const auto& definition : definitions)
+	{
+		offset += definition.size();
+		file.write(reinterpret_cast<const char*>(&offset), sizeof offset);
+	}
+
+	for (const auto& definition : definitions)
+		file.write(definition.data(), definition.size());
+}
+
+Dictionary::Dictionary()
+{
+}
+
+Dictionary::~Dictionary()
+{
+	unload();
+}
+
+void Dictionary::unload()
+{
+#ifndef __MINGW32__
+	if (mapping != nullptr)
+		munmap(mapping, mapping_size);
+#endif
+	mapping = nullptr;
+	mapping_size = 0;
+
+	storage.clear();
+	storage.shrink_to_fit();
+
+	definition_count = 0;
+	definition_offsets = nullptr;
+	definition_data = nullptr;
+	definition_size = 0;
+	source.clear();
+
+	through.clear();
+	lines.clear();
+	indexed = false;
+	packed.reset();
+	factor_states.clear();
+	factor_nodes.clear();
+	factor_moves.clear();
+
+	edges = nullptr;
+	edge_count = 0;
+	words = 0;
+}
+
+bool Dictionary::load(const string& filename, bool copy)
+{
+	unload();
+
+	std::ifstream file(filename, std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	// check for image header
+	char start[sizeof magic] {0};
+	file.read(start, sizeof start);
+	file.close();
+
+	if (std::memcmp(start, magic, sizeof magic) == 0)
+		return load_image(filename, copy);
+	return load_text(filename);
+}
+
+bool Dictionary::load_memory(const char* data, size_t size)
+{
+	unload();
+
+	storage.resize((size + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+	std::memcpy(storage.data(), data, size);
+	if (!attach(storage.data(), size))
+	{
+		unload();
+		return false;
+	}
+
+	return true;
+}
+
+bool Dictionary::load_static(const char* data, size_t size)
+{
+	unload();
+
+	if (!attach(data, size))
+	{
+		unload();
+		return false;
+	}
+
+	return true;
+}
+
+bool Dictionary::load_text(const string& filename)
+{
+	std::ifstream file(filename);
+	if (!file.is_open())
+		return false;
+
+	// definitions are skipped, only the words are kept
+	vector<string> list;
+	string line;
+	while (std::getline(file, line))
+	{
+		string word {line.substr(0, line.find_first_of(" \r"))};
+		if (!word.empty() && std::all_of(word.begin(), word.end(), [](char ch) { return ch >= 'A' && ch <= 'Z'; }))
+			list.push_back(word);
+	}
+	file.close();
+
+	std::sort(list.begin(), list.end());
+	list.erase(std::unique(list.begin(), list.end()), list.end());
+
+	build(list);
+
+	// remember where to find definitions
+	source = filename;
+
+	return true;
+}
+
+bool Dictionary::load_image(const string& filename, bool copy)
+{
+#ifndef __MINGW32__
+	if (!copy)
+		return map_image(filename);
+#endif
+
+	// read the whole image
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+		return false;
+
+	size_t size = file.tellg();
+	file.seekg(0);
+
+	storage.resize((size + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+	file.read(reinterpret_cast<char*>(storage.data()), size);
+	if (!file || !attach(storage.data(), size))
+	{
+		unload();
+		return false;
+	}
+
+	return true;
+}
+
+#ifndef __MINGW32__
+bool Dictionary::map_image(const string& filename)
+{
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(Header))
+	{
+		close(fd);
+		return false;
+	}
+
+	// shared, read-only mapping so every process can use the same pages
+	void* map = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return false;
+
+	mapping = map;
+	mapping_size = info.st_size;
+
+	if (!attach(mapping, mapping_size))
+	{
+		unload();
+		return false;
+	}
+
+	return true;
+}
+#endif
+
+bool Dictionary::attach(const void* image, size_t size)
+{
+	if (size < sizeof(Header))
+		return false;
+
+	const Header* header = reinterpret_cast<const Header*>(image);
+	if (std::memcmp(header->magic, magic, sizeof magic) != 0 || header->version != version)
+		return false;
+
+	if ((size - sizeof(Header)) / sizeof(uint32_t) < header->edges)
+		return false;
+
+	const uint32_t* e = reinterpret_cast<const uint32_t*>(header + 1);
+
+	// make sure lookups can't run off the end
+	if (header->edges > 0 && !(e[header->edges - 1] & last_bit))
+		return false;
+	for (uint32_t i = 0; i < header->edges; ++i)
+		if ((e[i] & letter_mask) >= 26 || (e[i] >> child_shift) >= header->edges)
+			return false;
+
+	edges = e;
+	edge_count = header->edges;
+	words = header->words;
+
+	size_t used = sizeof(Header) + edge_count * sizeof(uint32_t);
+	attach_definitions(reinterpret_cast<const char*>(image) + used, size - used);
+
+	return true;
+}
+
+void Dictionary::attach_definitions(const char* blob, size_t size)
+{
+	if (size < sizeof definitions_magic + sizeof(uint32_t) || std::memcmp(blob, definitions_magic, sizeof definitions_magic) != 0)
+		return;
+
+	uint32_t count = *reinterpret_cast<const uint32_t*>(blob + sizeof definitions_magic);
+	size_t table = sizeof definitions_magic + sizeof(uint32_t) + (count + size_t(1)) * sizeof(uint32_t);
+	if (count != words || size < table)
+		return;
+
+	// offsets are checked as they are used, so the blob isn't paged in here
+	definition_count = count;
+	definition_offsets = reinterpret_cast<const uint32_t*>(blob + sizeof definitions_magic + sizeof(uint32_t));
+	definition_data = blob + table;
+	definition_size = size - table;
+}
+
+void Dictionary::build(const vector<string>& sorted)
+{
+	DawgBuilder builder;
+	for (const auto& word : sorted)
+		builder.add(word);
+
+	vector<uint32_t> graph;
+	builder.finish(graph, terminal_bit, last_bit, child_shift);
+
+	Header header;
+	std::memcpy(header.magic, magic, sizeof magic);
+	header.version = version;
+	header.words = sorted.size();
+	header.edges = graph.size();
+
+	storage.resize(sizeof(Header) / sizeof(uint32_t));
+	std::memcpy(storage.data(), &header, sizeof header);
+	storage.insert(storage.end(), graph.begin(), graph.end());
+
+	attach(storage.data(), storage.size() * sizeof(uint32_t));
+}
+
+bool Dictionary::save(const string& filename) const
+{
+	string temp {filename + ".tmp"};
+	if (!write(temp))
+	{
+		std::remove(temp.c_str());
+		return false;
+	}
+
+	// replace in one step, since running servers may have the old file mapped
+#ifdef __MINGW32__
+	std::remove(filename.c_str());
+#endif
+	return std::rename(temp.c_str(), filename.c_str()) == 0;
+}
+
+bool Dictionary::save_source(const string& filename, const string& name) const
+{
+	std::ofstream file(filename);
+	if (!file.is_open())
+		return false;
+
+	const char* data = image();
+	size_t size = image_size();
+
+	file << "// generated by dictc, do not edit\n"
+	        "#include <cstddef>\n\n"
+	        "alignas(4) extern const unsigned char " << name << "[] {";
+
+	static const char hex[] {"0123456789abcdef"};
+	for (size_t i = 0; i < size; ++i)
+	{
+		unsigned char byte = data[i];
+		file << (i % 16 == 0 ? "\n\t" : " ") << "0x" << hex[byte >> 4] << hex[byte & 0xf] << ',';
+	}
+
+	file << "\n};\n\nextern const size_t " << name << "_size {" << size << "};\n";
+
+	return file.good();
+}
+
+bool Dictionary::write(const string& filename) const
+{
+	std::ofstream file(filename, std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	Header header;
+	std::memcpy(header.magic, magic, sizeof magic);
+	header.version = version;
+	header.words = words;
+	header.edges = edge_count;
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof header);
+	file.write(reinterpret_cast<const char*>(edges), edge_count * sizeof(uint32_t));
+
+	if (definition_offsets != nullptr)
+	{
+		// copy blob as is
+		file.write(definitions_magic, sizeof definitions_magic);
+		file.write(reinterpret_cast<const char*>(&definition_count), sizeof definition_count);
+		file.write(reinterpret_cast<const char*>(definition_offsets), (definition_count + 1) * sizeof(uint32_t));
+		file.write(definition_data, definition_size);
+	}
+	else if (!source.empty())
+	{
+		std::ifstream text(source);
+		if (!text.is_open())
+			return false;
+
+		// gather definitions in word order
+		vector<string> definitions(words);
+		bool any = false;
+		string line;
+		while (std::getline(text, line))
+		{
+			if (!line.empty() && line.back() == '\r')
+				line.pop_back();
+
+			auto pos = line.find_first_of(' ');
+			if (pos == string::npos)
+				continue;
+
+			uint32_t id = word_id(line.substr(0, pos));
+			if (id != no_word && definitions[id].empty())
+			{
+				definitions[id] = line.substr(pos + 1);
+				any = true;
+			}
+		}
+
+		if (any)
+			write_definitions(file, definitions);
+	}
+
+	return file.good();
+}
+
+void Dictionary::check_words(const vector<string>& batch, vector<bool>& valid) const
+{
+	const PackedWords* keys;
+	{
+		std::lock_guard<std::mutex> lock(packed_lock);
+		keys = packed.get();
+	}
+
+	if (keys != nullptr)
+	{
+		keys->check_words(batch, valid);
+		return;
+	}
+
+	valid.resize(batch.size());
+	for (size_t i = 0; i < batch.size(); ++i)
+		valid[i] = check_word(batch[i]);
+}
+
+void Dictionary::pack() const
+{
+	std::lock_guard<std::mutex> lock(packed_lock);
+	if (!packed)
+		packed.reset(new PackedWords(*this));
+}
+
+const uint32_t* Dictionary::walk(const string& word) const
+{
+	if (word.empty() || edge_count == 0)
+		return nullptr;
+
+	uint32_t node = 0;
+	const uint32_t* edge = nullptr;
+	for (size_t i = 0; i < word.size(); ++i)
+	{
+		// previous letter had nowhere to go
+		if (i > 0 && node == 0)
+			return nullptr;
+
+		if (word[i] < 'A' || word[i] > 'Z')
+			return nullptr;
+
+		edge = find_edge(node, word[i] - 'A');
+		if (edge == nullptr)
+			return nullptr;
+
+		node = *edge >> child_shift;
+	}
+
+	return edge;
+}
+
+bool Dictionary::check_word(const string& word) const
+{
+	const uint32_t* edge = walk(word);
+	return edge != nullptr && (*edge & terminal_bit) != 0;
+}
+
+bool Dictionary::is_prefix(const string& prefix) const
+{
+	if (prefix.empty())
+		return edge_count != 0;
+
+	return walk(prefix) != nullptr;
+}
+
+bool Dictionary::is_factor(const string& fragment) const
+{
+	if (is_prefix(fragment))
+		return true;
+
+	for (char ch : fragment)
+		if (ch < 'A' || ch > 'Z')
+			return false;
+
+	std::lock_guard<std::mutex> lock(factor_lock);
+	if (factor_nodes.empty())
+		factor_nodes.push_back(nullptr);
+
+	uint32_t state {0};
+	for (char ch : fragment)
+	{
+		state = factor_move(state, ch - 'A');
+		if (state == no_word)
+			return false;
+	}
+
+	return true;
+}
+
+uint32_t Dictionary::factor_move(uint32_t state, uint32_t letter) const
+{
+	const uint64_t key {uint64_t(state) * 26 + letter};
+	auto it = factor_moves.find(key);
+	if (it != factor_moves.end())
+		return it->second;
+
+	// leaving state 0 means scanning every edge, so do it once for all letters.
+	// every edge lies on some path from the root to a word
+	if (state == 0)
+	{
+		vector<vector<uint32_t>> next(26);
+		vector<bool> found(26, false);
+		for (uint32_t e = 0; e < edge_count; ++e)
+		{
+			const uint32_t l {edges[e] & letter_mask};
+			found[l] = true;
+			if (edges[e] >> child_shift)
+				next[l].push_back(edges[e] >> child_shift);
+		}
+
+		for (uint32_t l = 0; l < 26; ++l)
+			factor_moves[l] = found[l] ? add_factor_state(next[l]) : no_word;
+		return factor_moves[letter];
+	}
+
+	// follow letter from every node in the state. an edge without a child
+	// still counts, the fragment just can't grow any further that way
+	bool found {false};
+	vector<uint32_t> next;
+	for (uint32_t node : *factor_nodes[state])
+	{
+		const uint32_t* edge {find_edge(node, letter)};
+		if (edge == nullptr)
+			continue;
+
+		found = true;
+		if (*edge >> child_shift)
+			next.push_back(*edge >> child_shift);
+	}
+
+	uint32_t result {found ? add_factor_state(next) : no_word};
+	factor_moves[key] = result;
+	return result;
+}
+
+uint32_t Dictionary::add_factor_state(vector<uint32_t>& nodes) const
+{
+	std::sort(nodes.begin(), nodes.end());
+	nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+	auto inserted = factor_states.insert(std::make_pair(std::move(nodes), uint32_t(factor_nodes.size())));
+	if (inserted.second)
+		factor_nodes.push_back(&inserted.first->first);
+	return inserted.first->second;
+}
+
+uint64_t Dictionary::checksum() const
+{
+	// 64-bit FNV-1a
+	uint64_t h = 14695981039346656037ULL;
+	const char* data = image();
+	for (size_t i = 0; i < image_size(); ++i)
+	{
+		h ^= (unsigned char)data[i];
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+void Dictionary::each_word(const std::function<void(const string&)>& f) const
+{
+	if (edge_count == 0)
+		return;
+
+	string prefix;
+	each_word(0, prefix, f);
+}
+
+void Dictionary::each_word(uint32_t first, string& prefix, const std::function<void(const string&)>& f) const
+{
+	for (uint32_t i = first; ; ++i)
+	{
+		prefix.push_back('A' + (edges[i] & letter_mask));
+
+		if (edges[i] & terminal_bit)
+			f(prefix);
+
+		uint32_t child = edges[i] >> child_shift;
+		if (child != 0)
+			each_word(child, prefix, f);
+
+		prefix.pop_back();
+
+		if (edges[i] & last_bit)
+			return;
+	}
+}
+
+uint32_t Dictionary::count_through(uint32_t first) const
+{
+	uint32_t total = 0;
+	for (uint32_t i = first; ; ++i)
+	{
+		// every edge leads to at least one word, so 0 means not counted yet
+		if (through[i] == 0)
+		{
+			uint32_t child = edges[i] >> child_shift;
+			through[i] = ((edges[i] & terminal_bit) ? 1 : 0) + (child == 0 ? 0 : count_through(child));
+		}
+
+		total += through[i];
+
+		if (edges[i] & last_bit)
+			return total;
+	}
+}
+
+void Dictionary::build_index() const
+{
+	through.assign(edge_count, 0);
+	if (edge_count > 0)
+		count_through(0);
+
+	// find each word's line in the word list
+	if (!source.empty())
+	{
+		std::ifstream file(source, std::ios::binary);
+
+		lines.assign(words, no_word);
+		uint32_t offset = 0;
+		string line;
+		while (std::getline(file, line))
+		{
+			auto pos = line.find_first_of(' ');
+			if (pos != string::npos)
+			{
+				uint32_t id = rank(line.substr(0, pos));
+				if (id != no_word && lines[id] == no_word)
+					lines[id] = offset;
+			}
+
+			offset += line.size() + 1;
+		}
+	}
+
+	indexed = true;
+}
+
+uint32_t Dictionary::rank(const string& word) const
+{
+	if (word.empty() || edge_count == 0)
+		return no_word;
+
+	uint32_t id = 0;
+	uint32_t node = 0;
+	for (size_t i = 0; i < word.size(); ++i)
+	{
+		if (i > 0 && node == 0)
+			return no_word;
+
+		if (word[i] < 'A' || word[i] > 'Z')
+			return no_word;
+
+		uint32_t letter = word[i] - 'A';
+
+		// skip words under earlier letters
+		const uint32_t* edge = edges + node;
+		while ((*edge & letter_mask) < letter && !(*edge & last_bit))
+		{
+			id += through[edge - edges];
+			++edge;
+		}
+
+		if ((*edge & letter_mask) != letter)
+			return no_word;
+
+		if (i + 1 == word.size())
+			return (*edge & terminal_bit) ? id : no_word;
+
+		// the prefix itself comes before its extensions
+		if (*edge & terminal_bit)
+			++id;
+
+		node = *edge >> child_shift;
+	}
+
+	return no_word;
+}
+
+string Dictionary::read_definition(const string& word, uint32_t id) const
+{
+	if (id >= lines.size() || lines[id] == no_word)
+		return "";
+
+	std::ifstream file(source, std::ios::binary);
+	if (!file.is_open())
+		return "";
+
+	string line;
+	file.seekg(lines[id]);
+	std::getline(file, line);
+	if (!line.empty() && line.back() == '\r')
+		line.pop_back();
+
+	// file may have changed since it was indexed
+	if (line.compare(0, word.size() + 1, word + ' ') != 0)
+		return "";
+
+	return line.substr(word.size() + 1);
+}
+
+uint32_t Dictionary::word_id(const string& word) const
+{
+	std::lock_guard<std::mutex> lock(index_lock);
+	if (!indexed)
+		build_index();
+
+	return rank(word);
+}
+
+string Dictionary::define(const string& word) const
+{
+	std::lock_guard<std::mutex> lock(index_lock);
+	if (!indexed)
+		build_index();
+
+	uint32_t id = rank(word);
+	if (id == no_word)
+		return "";
+
+	if (definition_offsets != nullptr)
+	{
+		if (id >= definition_count)
+			return "";
+
+		uint32_t begin = definition_offsets[id];
+		uint32_t end = definition_offsets[id + 1];
+		if (begin > end || end > definition_size)
+			return "";
+
+		return string(definition_data + begin, end - begin);
+	}
+
+	return read_definition(word, id);
+}
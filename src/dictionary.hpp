@@ -0,0 +1,203 @@
+#ifndef DICTIONARY_HPP
+#define DICTIONARY_HPP
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class PackedWords;
+
+// word list stored as a DAWG (trie with shared suffixes)
+//
+// the graph is kept as a binary image (header followed by edges) which can be
+// written to disk by dictc and mapped back in without any parsing
+//
+// images are not compressed, on disk or when sent to clients. the DAWG already
+// takes words.txt from 1.7 MB down to 480 KB, and a compressed image would have
+// to be inflated into memory before use instead of being mapped in place
+//
+// definitions live outside the graph and are only touched when asked for: an
+// image may be followed by a definitions blob indexed by word id, while a
+// text word list is indexed the first time a definition is requested
+class Dictionary
+{
+public:
+	static const uint32_t version {1};
+	static const uint32_t no_word {UINT32_MAX};
+
+	struct Header
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t words;
+		uint32_t edges;
+	};
+
+private:
+	// each node is a run of edges sorted by letter, the last one flagged
+	// bits 0-4: letter, bit 5: word ends here, bit 6: last edge of node, bits 7-31: first edge of child (0 if none)
+	const uint32_t* edges {nullptr};
+	uint32_t edge_count {0};
+	uint32_t words {0};
+
+	// image built from a word list
+	std::vector<uint32_t> storage;
+	// image mapped from a file
+	void* mapping {nullptr};
+	size_t mapping_size {0};
+
+	// definitions blob following a mapped image
+	uint32_t definition_count {0};
+	const uint32_t* definition_offsets {nullptr};
+	const char* definition_data {nullptr};
+	size_t definition_size {0};
+	// text word list to read definitions from
+	std::string source;
+
+	// lazily built indices for looking up definitions
+	mutable std::mutex index_lock;
+	mutable std::vector<uint32_t> through; // words reachable through each edge, for ranking
+	mutable std::vector<uint32_t> lines; // file offset of each word's line in source
+	mutable bool indexed {false};
+
+	// short words as sorted keys, only built when asked for with pack
+	mutable std::mutex packed_lock;
+	mutable std::unique_ptr<PackedWords> packed;
+
+	// automaton for telling whether a fragment is part of a word, worked out
+	// from the graph only as far as fragments have been looked up. each state
+	// is the set of nodes (by first edge) a fragment can lead to when walked
+	// from anywhere, state 0 being every node
+	mutable std::mutex factor_lock;
+	mutable std::map<std::vector<uint32_t>, uint32_t> factor_states;
+	mutable std::vector<const std::vector<uint32_t>*> factor_nodes; // nodes of each state, nullptr for 0
+	mutable std::unordered_map<uint64_t, uint32_t> factor_moves; // state * 26 + letter to state, or no_word
+
+	static const uint32_t letter_mask {0x1f};
+	static const uint32_t terminal_bit {1 << 5};
+	static const uint32_t last_bit {1 << 6};
+	static const unsigned int child_shift {7};
+
+	// find edge for letter in node starting at first, or nullptr
+	inline const uint32_t* find_edge(uint32_t first, uint32_t letter) const
+	{
+		for (const uint32_t* edge = edges + first; ; ++edge)
+		{
+			uint32_t l = *edge & letter_mask;
+			if (l == letter)
+				return edge;
+			// edges are sorted, so we can stop early
+			if (l > letter || (*edge & last_bit))
+				return nullptr;
+		}
+	}
+
+	// follow word from the root, returning edge for its last letter or nullptr
+	const uint32_t* walk(const std::string& word) const;
+
+	// build from sorted, unique words
+	void build(const std::vector<std::string>& sorted);
+	// point at image, checking that it is well formed
+	bool attach(const void* image, size_t size);
+	// find definitions blob in the bytes following the image
+	void attach_definitions(const char* blob, size_t size);
+	bool load_text(const std::string& filename);
+	bool load_image(const std::string& filename, bool copy);
+#ifndef __MINGW32__
+	bool map_image(const std::string& filename);
+#endif
+	bool write(const std::string& filename) const;
+	void unload();
+
+	// words reachable through edges in node starting at first
+	uint32_t count_through(uint32_t first) const;
+	// build indices needed by define, call with index_lock held
+	void build_index() const;
+	// state reached from state by letter, or no_word. call with factor_lock held
+	uint32_t factor_move(uint32_t state, uint32_t letter) const;
+	// id of the state with the given nodes, adding it if it is new
+	uint32_t add_factor_state(std::vector<uint32_t>& nodes) const;
+	// word id without building the index first
+	uint32_t rank(const std::string& word) const;
+	// read definition from source, empty if there is none
+	std::string read_definition(const std::string& word, uint32_t id) const;
+	// call f for each word below node starting at first, prefix holds letters so far
+	void each_word(uint32_t first, std::string& prefix, const std::function<void(const std::string&)>& f) const;
+public:
+	Dictionary();
+	~Dictionary();
+
+	Dictionary(const Dictionary&) = delete;
+	Dictionary& operator=(const Dictionary&) = delete;
+
+	// read binary image or word list (one word per line, optionally followed by a space and definition)
+	// images are mapped in place unless copy is set. a mapped file must only
+	// ever be replaced by renaming over it, since rewriting it in place
+	// changes or truncates the pages under us
+	bool load(const std::string& filename, bool copy = false);
+	// copy binary image from memory, e.g. one received from a server
+	bool load_memory(const char* data, size_t size);
+	// use binary image in memory that outlives the dictionary, without copying
+	bool load_static(const char* data, size_t size);
+	// write binary image (via a temporary file, so mapped copies aren't clobbered)
+	bool save(const std::string& filename) const;
+	// write binary image as C++ source defining a byte array with the given name
+	bool save_source(const std::string& filename, const std::string& name) const;
+
+	bool check_word(const std::string& word) const;
+	inline bool is_word(const std::string& word) const
+	{
+		return check_word(word);
+	}
+	// whether any word starts with prefix, takes time proportional to its length
+	bool is_prefix(const std::string& prefix) const;
+	// whether fragment appears anywhere in some word, i.e. it can still grow into one
+	// a walk through cached states, except for the first time a state is left by a letter
+	bool is_factor(const std::string& fragment) const;
+	// set valid[i] to whether words[i] is a word. uses the sorted keys if pack was
+	// called, otherwise checks one by one
+	void check_words(const std::vector<std::string>& words, std::vector<bool>& valid) const;
+	// keep short words as sorted keys for check_words. a bit faster for big
+	// batches, but takes about 1.2 MB of heap for words.txt and a while to build
+	void pack() const;
+
+	// position of word in sorted order, or no_word
+	uint32_t word_id(const std::string& word) const;
+	// get definition, empty if word is missing or has none
+	std::string define(const std::string& word) const;
+
+	// call f for every word, in sorted order
+	void each_word(const std::function<void(const std::string&)>& f) const;
+
+	inline uint32_t size() const
+	{
+		return words;
+	}
+
+	// binary image of the graph, without definitions
+	inline const char* image() const
+	{
+		return edges == nullptr ? nullptr : reinterpret_cast<const char*>(edges) - sizeof(Header);
+	}
+
+	inline size_t image_size() const
+	{
+		return edges == nullptr ? 0 : sizeof(Header) + edge_count * sizeof(uint32_t);
+	}
+
+	// hash of the image, identifies the word list
+	uint64_t checksum() const;
+
+	// approximate memory used by the graph
+	inline size_t footprint() const
+	{
+		return edge_count * sizeof(uint32_t);
+	}
+};
+
+#endif
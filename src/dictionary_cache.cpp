@@ -0,0 +1,117 @@
+#include <map>
+#include <mutex>
+
+#include <sys/stat.h>
+
+#include "dictionary_cache.hpp"
+
+using std::string;
+
+// generated from words.txt at build time
+extern const unsigned char default_dictionary[];
+extern const size_t default_dictionary_size;
+
+// what we know about a file in the cache
+struct CacheEntry
+{
+	time_t mtime;
+	off_t size;
+	std::shared_ptr<const Dictionary> dictionary;
+};
+
+static std::mutex cache_lock;
+static std::map<string, CacheEntry> cache;
+// mtime and size of files that failed to load, so polling doesn't retry them until they change
+static std::map<string, std::pair<time_t, off_t>> failed;
+
+// the default dictionary, already in memory so there is never anything to reload
+static std::shared_ptr<const Dictionary> get_builtin()
+{
+	static std::shared_ptr<const Dictionary> builtin;
+	std::lock_guard<std::mutex> lock(cache_lock);
+
+	if (!builtin)
+	{
+		std::shared_ptr<Dictionary> dictionary {new Dictionary()};
+		if (!dictionary->load_static(reinterpret_cast<const char*>(default_dictionary), default_dictionary_size))
+			return nullptr;
+		builtin = dictionary;
+	}
+
+	return builtin;
+}
+
+// load file and replace its cache entry
+static std::shared_ptr<const Dictionary> load(const string& filename, const struct stat& info)
+{
+	// loading can take a while, so don't hold the lock for it. files here are
+	// watched for changes, which invites editing them in place, so images are
+	// copied rather than mapped
+	std::shared_ptr<Dictionary> dictionary {new Dictionary()};
+	bool loaded {dictionary->load(filename, true)};
+
+	std::lock_guard<std::mutex> lock(cache_lock);
+	if (!loaded)
+	{
+		failed[filename] = std::make_pair(info.st_mtime, info.st_size);
+		return nullptr;
+	}
+
+	failed.erase(filename);
+	cache[filename] = CacheEntry {info.st_mtime, info.st_size, dictionary};
+
+	return dictionary;
+}
+
+std::shared_ptr<const Dictionary> DictionaryCache::get(const string& filename)
+{
+	if (filename.empty())
+		return get_builtin();
+
+	struct stat info;
+	if (stat(filename.c_str(), &info) != 0)
+		return nullptr;
+
+	{
+		std::lock_guard<std::mutex> lock(cache_lock);
+
+		auto it = cache.find(filename);
+		if (it != cache.end() && it->second.mtime == info.st_mtime && it->second.size == info.st_size)
+			return it->second.dictionary;
+	}
+
+	// new or changed file
+	return load(filename, info);
+}
+
+std::shared_ptr<const Dictionary> DictionaryCache::reload(const string& filename)
+{
+	if (filename.empty())
+		return get_builtin();
+
+	struct stat info;
+	if (stat(filename.c_str(), &info) != 0)
+		return nullptr;
+
+	return load(filename, info);
+}
+
+bool DictionaryCache::changed(const string& filename)
+{
+	if (filename.empty())
+		return false;
+
+	struct stat info;
+	if (stat(filename.c_str(), &info) != 0)
+		return false;
+
+	std::lock_guard<std::mutex> lock(cache_lock);
+
+	// already tried this version of the file
+	auto bad = failed.find(filename);
+	if (bad != failed.end() && bad->second.first == info.st_mtime && bad->second.second == info.st_size)
+		return false;
+
+	auto it = cache.find(filename);
+	return it == cache.end() || it->second.mtime != info.st_mtime || it->second.size != info.st_size;
+}
@@ -0,0 +1,29 @@
+#ifndef DICTIONARY_CACHE_HPP
+#define DICTIONARY_CACHE_HPP
+
+#include <memory>
+#include <string>
+
+#include "dictionary.hpp"
+
+// process wide registry of loaded dictionaries
+//
+// games share one copy per file, and it is kept around between games so a
+// restarted server doesn't have to load it again. a file is only reloaded
+// when it changes on disk; games using the old copy keep it until they end.
+// images are read into memory rather than mapped, so a file edited in place
+// can't change under a running game
+class DictionaryCache
+{
+public:
+	// get dictionary for file, loading it if needed, or nullptr if it can't be read
+	// an empty filename gets the default dictionary built into the program
+	static std::shared_ptr<const Dictionary> get(const std::string& filename);
+	// load file again even if it looks unchanged, or nullptr if it can't be read
+	static std::shared_ptr<const Dictionary> reload(const std::string& filename);
+	// whether file differs from the copy in the cache (cheap, only stats the file)
+	// a file that failed to load doesn't count as changed until it changes again
+	static bool changed(const std::string& filename);
+};
+
+#endif
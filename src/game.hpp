@@ -3,16 +3,19 @@
 
 #include <fstream>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <SFML/System.hpp>
 
 #include "bunch.hpp"
+#include "dictionary_cache.hpp"
 #include "player.hpp"
 
 class Game
 {
-	std::map<std::string, std::string> dictionary;
+	std::shared_ptr<const Dictionary> dictionary;
 	uint8_t bunch_num;
 	uint8_t bunch_den;
 	unsigned int* counts;
@@ -35,7 +38,32 @@ public:
 
 	inline bool check_word(const std::string& word) const
 	{
-		return dictionary.count(word) == 1;
+		return dictionary && dictionary->check_word(word);
+	}
+
+	inline void check_words(const std::vector<std::string>& words, std::vector<bool>& valid) const
+	{
+		if (dictionary)
+			dictionary->check_words(words, valid);
+		else
+			valid.assign(words.size(), false);
+	}
+
+	inline const std::shared_ptr<const Dictionary>& get_dictionary() const
+	{
+		return dictionary;
+	}
+
+	// switch word lists, only safe before the game starts
+	inline void set_dictionary(const std::shared_ptr<const Dictionary>& dict)
+	{
+		dictionary = dict;
+	}
+
+	// only reads definitions on demand, so this may touch the disk
+	inline std::string define(const std::string& word) const
+	{
+		return dictionary ? dictionary->define(word) : "";
 	}
 
 	inline bool has_player(const std::string& id) const
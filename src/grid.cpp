@@ -1,132 +1,67 @@
+#include <algorithm>
+#include <cmath>
+
 #include "grid.hpp"
 
-using std::array;
-using std::string;
 using std::vector;
 
-Grid::~Grid()
+// tint for runs that can't become words
+static const sf::Color dead_end_color {255, 190, 120};
+
+uint32_t Grid::take(Tile* tile)
 {
-	for (auto tile : grid)
-		if (tile != nullptr)
-			delete tile;
+	uint32_t handle;
+	if (free_handles.empty())
+	{
+		handle = colors.size();
+		colors.push_back(tile->get_color());
+	}
+	else
+	{
+		handle = free_handles.back();
+		free_handles.pop_back();
+		colors[handle] = tile->get_color();
+	}
+
+	delete tile;
+	return handle;
 }
 
-unsigned int Grid::convert(int x, int y) const
+Tile* Grid::release(uint32_t handle, char letter, int x, int y)
 {
-	if (x >= 0 && y >= 0)
-		return 4 * bijection(x, y);
-	if (x < 0 && y >= 0)
-		return 4 * bijection(-x - 1, y) + 1;
-	if (x >= 0 && y < 0)
-		return 4 * bijection(x, -y - 1) + 2;
-	else
-		return 4 * bijection(-x - 1, -y - 1) + 3;
+	Tile* tile {new Tile(letter)};
+	tile->set_grid_pos(x, y);
+	tile->set_color(colors[handle]);
+	free_handles.push_back(handle);
+	return tile;
 }
 
-// for checking connectedness of grid
-void Grid::traverse(int x, int y)
+void Grid::set_color(int x, int y, const sf::Color& color)
 {
-	Tile* tile {get(x, y)};
-	if (tile == nullptr || tile->marked)
-		return;
-
-	tile->marked = true;
-	traverse(x - 1, y);
-	traverse(x + 1, y);
-	traverse(x, y - 1);
-	traverse(x, y + 1);
+	uint32_t handle;
+	if (board.get(x, y, &handle) != 0)
+		colors[handle] = color;
 }
 
 sf::Vector2f Grid::get_center() const
 {
-	return ((sf::Vector2f)(max + min) / (float)2.0 + sf::Vector2f(0.5, 0.5)) * (float)PPB;
+	return ((sf::Vector2f)(get_max() + get_min()) / (float)2.0 + sf::Vector2f(0.5, 0.5)) * (float)PPB;
 }
 
-// return the tile at the coords
-Tile* Grid::get(int x, int y) const
+// return the letter at the coords
+char Grid::get(int x, int y) const
 {
-	unsigned int n {convert(x, y)};
-	if (n >= grid.size())
-		return nullptr;
-	return grid[n];
+	return board.get(x, y);
 }
 
 // remove the tile at the coords and return it
 Tile* Grid::remove(int x, int y)
 {
-	unsigned int n {convert(x, y)};
-	// if in bounds
-	if (n < grid.size())
-	{
-		Tile* tile {grid[n]};
-
-		// return if nothing was changed
-		if (tile == nullptr)
-			return nullptr;
-
-		--tiles;
-
-		// shrink grid, if possible
-		grid[n] = nullptr;
-		for (n = grid.size(); n > 0; --n)
-			if (grid[n - 1] != nullptr)
-				break;
-
-		grid.resize(n, nullptr);
-
-		if (tiles == 0)
-		{
-			// reset center if all tiles removed
-			min = sf::Vector2i(0, 0);
-			max = sf::Vector2i(0, 0);
-		}
-		// if tile is removed at a boundary
-		else if (x == max.x || x == min.x || y == max.y || y == min.y)
-		{
-			// completely recalculate center :/
-			bool first {true};
-			for (auto tl : grid)
-			{
-				if (tl != nullptr)
-				{
-					const sf::Vector2i& pos {tl->get_grid_pos()};
-					if (first)
-						min = max = pos;
-					else
-					{
-						if (pos.x > max.x)
-							max.x = pos.x;
-						else if (pos.x < min.x)
-							min.x = pos.x;
-						if (pos.y > max.y)
-							max.y = pos.y;
-						else if (pos.y < min.y)
-							min.y = pos.y;
-					}
-					first = false;
-				}
-			}
-		}
-
-		// check for created words
-		if (get(x + 1, y) != nullptr && get(x + 2, y) != nullptr)
-			hwords[sf::Vector2i(x + 1, y)] = true;
-
-		if (get(x, y + 1) != nullptr && get(x, y + 2) != nullptr)
-			vwords[sf::Vector2i(x, y + 1)] = true;
-
-		// check for destroyed words
-		hwords.erase(sf::Vector2i(x, y));
-		if (get(x - 2, y) == nullptr)
-			hwords.erase(sf::Vector2i(x - 1, y));
-
-		vwords.erase(sf::Vector2i(x, y));
-		if (get(x, y - 2) == nullptr)
-			vwords.erase(sf::Vector2i(x, y - 1));
-
-		return tile;
-	}
-	return nullptr;
+	uint32_t handle;
+	char letter {board.remove(x, y, &handle)};
+	if (letter == 0)
+		return nullptr;
+	return release(handle, letter, x, y);
 }
 
 // exchange the tile at the coords for the given one, and return it
@@ -134,176 +69,110 @@ Tile* Grid::swap(int x, int y, Tile* tile)
 {
 	if (tile == nullptr)
 		throw std::runtime_error("attempt to place NULL tile");
-	unsigned int n {convert(x, y)};
-	if (n >= grid.size())
-		grid.resize(n + 1, nullptr);
-	Tile* swp {grid[n]};
-	tile->set_grid_pos(x, y);
-	grid[n] = tile;
-
-	if (swp != nullptr)
-		return swp;
-
-	if (tiles == 0)
-		min = max = sf::Vector2i(x, y);
-	else
-	{
-		if (x > max.x)
-			max.x = x;
-		else if (x < min.x)
-			min.x = x;
-		if (y > max.y)
-			max.y = y;
-		else if (y < min.y)
-			min.y = y;
-	}
-	++tiles;
 
-	last = sf::Vector2i(x, y);
+	char letter {tile->ch()};
+	uint32_t old;
+	char swp {board.place(x, y, letter, take(tile), &old)};
+	if (swp == 0)
+		return nullptr;
+	return release(old, swp, x, y);
+}
 
-	// check for created words
-	if (get(x - 1, y) == nullptr)
+vector<Tile*> Grid::place_many(const vector<std::pair<sf::Vector2i, Tile*>>& tiles)
+{
+	vector<Board::Placement> placements;
+	placements.reserve(tiles.size());
+	for (const auto& pair : tiles)
 	{
-		if (get(x + 1, y) != nullptr)
-			hwords[sf::Vector2i(x, y)] = true;
-	}
-	else if (get(x - 2, y) == nullptr)
-		hwords[sf::Vector2i(x - 1, y)] = true;
+		if (pair.second == nullptr)
+			throw std::runtime_error("attempt to place NULL tile");
 
-	if (get(x, y - 1) == nullptr)
-	{
-		if (get(x, y + 1) != nullptr)
-			vwords[sf::Vector2i(x, y)] = true;
+		char letter {pair.second->ch()};
+		placements.push_back(Board::Placement {pair.first.x, pair.first.y, letter, take(pair.second)});
 	}
-	else if (get(x, y - 2) == nullptr)
-		vwords[sf::Vector2i(x, y - 1)] = true;
 
-	// check for destroyed words
-	if (get(x + 1, y) != nullptr)
-		hwords.erase(sf::Vector2i(x + 1, y));
+	board.place_many(placements);
 
-	if (get(x, y + 1) != nullptr)
-		vwords.erase(sf::Vector2i(x, y + 1));
+	vector<Tile*> displaced;
+	for (const auto& placement : placements)
+		if (placement.letter != 0)
+			displaced.push_back(release(placement.handle, placement.letter, placement.x, placement.y));
+	return displaced;
+}
 
-	return nullptr;
+vector<Tile*> Grid::remove_many(const vector<sf::Vector2i>& positions)
+{
+	vector<Board::Placement> placements;
+	placements.reserve(positions.size());
+	for (const auto& pos : positions)
+		placements.push_back(Board::Placement {pos.x, pos.y, 0, 0});
+
+	board.remove_many(placements);
+
+	vector<Tile*> removed;
+	removed.reserve(placements.size());
+	for (const auto& placement : placements)
+		removed.push_back(placement.letter != 0 ? release(placement.handle, placement.letter, placement.x, placement.y) : nullptr);
+	return removed;
 }
 
 void Grid::clear()
 {
-	for (auto tile : grid)
-		if (tile != nullptr)
-			delete tile;
-	grid.clear();
-	tiles = 0;
-	min = {0, 0};
-	max = {0, 0};
-	defined.clear();
-	hwords.clear();
-	vwords.clear();
+	board.clear();
+	colors.clear();
+	free_handles.clear();
 }
 
 // animate tiles
 void Grid::step(float time)
 {
-	for (auto tile: grid)
+	board.each_cell([this, time](const Board::Cell& cell)
 	{
-		if (tile != nullptr)
+		sf::Color& color = colors[cell.handle];
+		color = color + sf::Color(time * 300, time * 300, time * 300);
+
+		// runs that can't become words stay tinted
+		if (cell.dead_end)
 		{
-			auto color = tile->get_color();
-			tile->set_color(color + sf::Color(time * 300, time * 300, time * 300));
+			color.g = std::min(color.g, dead_end_color.g);
+			color.b = std::min(color.b, dead_end_color.b);
 		}
-	}
+	});
 }
 
 // test if grid has at least one word and is continuous
-bool Grid::is_continuous()
+bool Grid::is_continuous(unsigned int* strays)
 {
+	if (strays != nullptr)
+		*strays = 0;
+
 	// need at least one word to be valid (also we should never get here if grid is empty)
-	if (hwords.size() == 0 && vwords.size() == 0)
+	if (!board.has_words())
 		return false;
 
-	auto start = hwords.begin();
-	if (hwords.size() == 0)
-		start = vwords.begin();
-
-	// grid must be continuous
-	for (auto tile: grid)
-		if (tile != nullptr)
-			tile->marked = false;
-
-	// starting points guaranteed to be non-null
-	traverse(start->first.x, start->first.y);
-
-	bool valid {true};
-	for (auto tile: grid)
-	{
-		if (tile != nullptr && !tile->marked)
-		{
-			valid = false;
-			tile->set_color(sf::Color(255, 50, 50));
-		}
-	}
-
-	return valid;
-}
+	vector<Coord> cut_off;
+	unsigned int groups {board.find_strays(cut_off)};
+	for (const auto& pos : cut_off)
+		set_color(pos.x, pos.y, sf::Color(255, 50, 50));
 
-gridword_map& Grid::get_words()
-{
-	std::stringstream temp;
-	vector<string> defns;
-	Tile* tile;
-	words.clear();
-
-	// get words
-	bool define; // whether we should define this word
-	for (auto& pair: hwords)
-	{
-		temp.str("");
-		define = false;
-		for (int x = pair.first.x; (tile = get(x, pair.first.y)) != nullptr; x++)
-		{
-			temp << tile->ch();
-			if (x == last.x && pair.first.y == last.y)
-				define = true;
-		}
-		if (define)
-			defns.push_back(temp.str());
-		if (!words.count(temp.str()))
-			words[temp.str()] = vector<array<int, 3>>();
-		words[temp.str()].push_back(array<int, 3>{{pair.first.x, pair.first.y, 0}});
-	}
-	for (auto& pair: vwords)
-	{
-		temp.str("");
-		define = false;
-		for (int y = pair.first.y; (tile = get(pair.first.x, y)) != nullptr; y++)
-		{
-			temp << tile->ch();
-			if (pair.first.x == last.x && y == last.y)
-				define = true;
-		}
-		if (define)
-			defns.push_back(temp.str());
-		if (!words.count(temp.str()))
-			words[temp.str()] = vector<array<int, 3>>();
-		words[temp.str()].push_back(array<int, 3>{{pair.first.x, pair.first.y, 1}});
-	}
+	if (strays != nullptr)
+		*strays = groups;
 
-	return words;
+	return groups == 0;
 }
 
 bool Grid::highlight(char ch)
 {
 	bool found = false;
 
-	for (auto tile : grid)
+	board.each_cell([this, ch, &found](const Board::Cell& cell)
 	{
-		if (tile && tile->ch() == ch)
+		if (cell.letter == ch)
 		{
-			tile->set_color(sf::Color(50, 50, 255));
+			colors[cell.handle] = sf::Color(50, 50, 255);
 			found = true;
 		}
-	}
+	});
 
 	return found;
 }
@@ -311,15 +180,27 @@ bool Grid::highlight(char ch)
 void Grid::bad_word(int x, int y, int dir)
 {
 	// TODO with multiplayer games, the word might no longer exist!!!
-	Tile* tile;
 	int coord[2];
-	for (coord[0] = x, coord[1] = y; (tile = get(coord[0], coord[1])) != nullptr; coord[dir]++)
-		tile->set_color(sf::Color(255, 50, 50));
+	for (coord[0] = x, coord[1] = y; get(coord[0], coord[1]) != 0; coord[dir]++)
+		set_color(coord[0], coord[1], sf::Color(255, 50, 50));
 }
 
 void Grid::draw_on(sf::RenderWindow& window) const
 {
-	for (auto tile: grid)
-		if (tile != nullptr)
-			tile->draw_on(window);
+	// only what the view can show
+	const sf::View& view {window.getView()};
+	sf::Vector2f corner {view.getCenter() - view.getSize() / 2.f};
+	int left {(int)std::floor(corner.x / PPB)};
+	int top {(int)std::floor(corner.y / PPB)};
+	int right {(int)std::floor((corner.x + view.getSize().x) / PPB)};
+	int bottom {(int)std::floor((corner.y + view.getSize().y) / PPB)};
+
+	sf::Sprite sprite;
+	board.each_cell_in(left, top, right - left + 1, bottom - top + 1, [this, &window, &sprite](const Board::Cell& cell)
+	{
+		sprite.setTexture(Tile::texture[cell.letter - 'A'].getTexture());
+		sprite.setPosition(cell.x * (int)PPB, cell.y * (int)PPB);
+		sprite.setColor(colors[cell.handle]);
+		window.draw(sprite);
+	});
 }
@@ -1,72 +1,62 @@
 #ifndef GRID_HPP
 #define GRID_HPP
 
-#include <array>
-#include <map>
+#include <cstdint>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <SFML/Graphics.hpp>
 
+#include "board.hpp"
 #include "constants.hpp"
+#include "dictionary.hpp"
 #include "tile.hpp"
 
-// for hwords and vwords vectors
-
-// map used for associating strings to position/direction in grid
-typedef std::map<std::string, std::vector<std::array<int, 3>>> gridword_map;
-
-namespace std
-{
-	template<> struct less<sf::Vector2i>
-	{
-		bool operator() (const sf::Vector2i& lhs, const sf::Vector2i& rhs)
-		{
-			return lhs.x < rhs.x || (lhs.x == rhs.x && lhs.y < rhs.y);
-		}
-	};
-}
-
+// tiles on a board, for drawing and moving them around
+//
+// the letters themselves and everything worked out from them live in the
+// board, which tags each letter with a handle. tiles placed here stop being
+// objects of their own: all the grid keeps for drawing them is a color per
+// handle, so animating and drawing are passes over contiguous arrays
 class Grid
 {
-	gridword_map words; // for checking grid
-	std::vector<Tile*> grid;
-	unsigned int tiles {0};
-	sf::Vector2i min {0, 0};
-	sf::Vector2i max {0, 0};
-	sf::Vector2i last;
-	std::vector<std::string> defined;
-	std::map<sf::Vector2i, bool> hwords;
-	std::map<sf::Vector2i, bool> vwords;
-
-	// for converting from 2D coords to vector positions
-	inline unsigned int bijection(unsigned x, unsigned int y) const
-	{
-		return ((x + y) * (x + y + 1)) / 2 + x;
-	}
-
-	unsigned int convert(int x, int y) const;
-	// for checking connectedness of grid
-	void traverse(int x, int y);
+	Board board;
+	// colors by handle, and handles free for reuse
+	std::vector<sf::Color> colors;
+	std::vector<uint32_t> free_handles;
+
+	// give tile's color a handle, deleting the tile
+	uint32_t take(Tile* tile);
+	// make a tile for letter at x, y from the handle's color, freeing the handle
+	Tile* release(uint32_t handle, char letter, int x, int y);
+	// set color of tile at x, y
+	void set_color(int x, int y, const sf::Color& color);
 public:
-	~Grid();
-
-	inline const std::vector<Tile*>& internal() const
+	// letters without the graphics, e.g. for handing to code without SFML
+	inline const Board& get_board() const
 	{
-		return grid;
+		return board;
 	}
 
 	// return center of bounding box
 	sf::Vector2f get_center() const;
 
-	// return tile at x, y
-	Tile* get(int x, int y) const;
+	// return letter at x, y, or 0 if empty
+	char get(int x, int y) const;
 	// remove tile at x, y and return it
 	Tile* remove(int x, int y);
 	// exchange tile at x, y for the given one, and return it
+	// the grid takes over the tile, so it must not be used afterwards
 	Tile* swap(int x, int y, Tile* tile);
+	// put many tiles down at once, returning the tiles they displaced
+	// words and connectivity are only worked out once for the lot
+	std::vector<Tile*> place_many(const std::vector<std::pair<sf::Vector2i, Tile*>>& tiles);
+	// remove tiles at many positions at once, returning them (nullptr where empty)
+	std::vector<Tile*> remove_many(const std::vector<sf::Vector2i>& positions);
 	// sf::Vector2i versions of the previous
-	inline Tile* get(const sf::Vector2i& pos) const
+	inline char get(const sf::Vector2i& pos) const
 	{
 		return get(pos.x, pos.y);
 	}
@@ -81,14 +71,14 @@ public:
 		return swap(pos.x, pos.y, tile);
 	}
 
-	inline const sf::Vector2i& get_min() const
+	inline sf::Vector2i get_min() const
 	{
-		return min;
+		return sf::Vector2i(board.get_min().x, board.get_min().y);
 	}
 
-	inline const sf::Vector2i& get_max() const
+	inline sf::Vector2i get_max() const
 	{
-		return max;
+		return sf::Vector2i(board.get_max().x, board.get_max().y);
 	}
 
 	// remove all tiles
@@ -97,13 +87,48 @@ public:
 	// animate tiles
 	void step(float time);
 
-	// check if topology of grid is valid
-	bool is_continuous();
+	// identifies the layout of letters, for remembering results about it
+	inline uint64_t get_hash() const
+	{
+		return board.get_hash();
+	}
+
+	// whether all tiles are connected, in constant time
+	inline bool is_connected() const
+	{
+		return board.is_connected();
+	}
+
+	// check if topology of grid is valid, marking tiles cut off from the largest group
+	// strays is set to the number of groups cut off
+	bool is_continuous(unsigned int* strays = nullptr);
+	// for telling which words changed since some point
+	inline unsigned int get_stamp() const
+	{
+		return board.get_stamp();
+	}
+
 	// get map of words to vector of position/direction triplets
-	gridword_map& get_words();
+	// only words changed after since, if given
+	inline gridword_map& get_words(unsigned int since = 0)
+	{
+		return board.get_words(since);
+	}
+
 	bool highlight(char ch);
 	// mark a bad word starting at x, y, oriented in dir
 	void bad_word(int x, int y, int dir);
+	// tint runs that aren't part of any word, among those changed since the last check
+	inline void check_prefixes(const Dictionary& dictionary)
+	{
+		board.check_prefixes(dictionary);
+	}
+
+	// tint runs that aren't part of any word, anywhere in the grid
+	inline void recheck_prefixes(const Dictionary& dictionary)
+	{
+		board.recheck_prefixes(dictionary);
+	}
 
 	void draw_on(sf::RenderWindow& window) const;
 };
@@ -133,14 +133,6 @@ void Hand::reshuffle()
 	std::copy(v.begin(), v.end(), std::back_inserter(scram));
 }
 
-bool Hand::is_empty() const
-{
-	for (char ch = 'A'; ch <= 'Z'; ch++)
-		if (has_any(ch))
-			return false;
-	return true;
-}
-
 void Hand::clear()
 {
 	for (char ch = 'A'; ch <= 'Z'; ch++)
@@ -149,6 +141,7 @@ void Hand::clear()
 			delete tile;
 		tiles[ch - 'A'].clear();
 	}
+	rack.clear();
 	scram.clear();
 	sort.clear();
 	single.clear();
@@ -158,6 +151,7 @@ void Hand::clear()
 void Hand::add_tile(Tile* tile)
 {
 	tiles[tile->ch() - 'A'].push_back(tile);
+	rack.add(tile->ch());
 
 	tile->set_color(sf::Color::White);
 
@@ -193,6 +187,7 @@ Tile* Hand::remove_tile(char ch)
 	{
 		tile = tiles[ch - 'A'].back();
 		tiles[ch - 'A'].pop_back();
+		rack.remove(ch);
 
 		// update persistent structures
 		scram.remove(tile);
@@ -2,17 +2,22 @@
 #define HAND_HPP
 
 #include <algorithm>
+#include <array>
 #include <list>
 #include <sstream>
 
 #include <SFML/Graphics.hpp>
 
 #include "constants.hpp"
+#include "rack.hpp"
 #include "tile.hpp"
 
+// tiles in a hand, drawn in one of several arrangements
+// which letters there are is kept in a Rack, the rest is just for drawing
 // TODO inefficient
 class Hand
 {
+	Rack rack;
 	std::vector<Tile*> tiles[26];
 	std::list<Tile*> scram; // for shuffle
 	std::list<Tile*> sort; // for ordered
@@ -40,17 +45,26 @@ public:
 
 	inline unsigned int count(char ch) const
 	{
-		return tiles[ch - 'A'].size();
+		return rack.count(ch);
 	}
 
 	inline bool has_any(char ch) const
 	{
-		return count(ch) > 0;
+		return rack.has_any(ch);
+	}
+
+	// letters without the tiles, e.g. for AnagramIndex
+	inline const Rack& get_rack() const
+	{
+		return rack;
 	}
 
 	void set_view(const sf::View& view);
 
-	bool is_empty() const;
+	inline bool is_empty() const
+	{
+		return rack.is_empty();
+	}
 
 	void clear();
 
@@ -0,0 +1,93 @@
+#include <algorithm>
+
+#include "dictionary.hpp"
+#include "packed_words.hpp"
+
+using std::string;
+using std::vector;
+
+uint64_t PackedWords::pack(const string& word)
+{
+	if (word.empty() || word.size() > max_length)
+		return 0;
+
+	uint64_t key = 0;
+	for (char ch : word)
+	{
+		if (ch < 'A' || ch > 'Z')
+			return 0;
+		key = (key << 5) | uint64_t(ch - 'A' + 1);
+	}
+	return key;
+}
+
+PackedWords::PackedWords(const Dictionary& dict)
+	: dictionary(dict)
+{
+	dictionary.each_word([this](const string& word)
+	{
+		uint64_t key = pack(word);
+		if (key != 0)
+			keys.push_back(key);
+	});
+
+	// words come out sorted, but keys of different lengths don't
+	std::sort(keys.begin(), keys.end());
+}
+
+bool PackedWords::check_word(const string& word) const
+{
+	uint64_t key = pack(word);
+	if (key == 0)
+		return dictionary.check_word(word);
+
+	return !keys.empty() && keys[search(key)] == key;
+}
+
+void PackedWords::check_words(const vector<string>& words, vector<bool>& valid) const
+{
+	valid.assign(words.size(), false);
+
+	// gather packable words, leave the rest to the dictionary
+	vector<uint64_t> batch;
+	vector<size_t> index;
+	batch.reserve(words.size());
+	index.reserve(words.size());
+	for (size_t i = 0; i < words.size(); ++i)
+	{
+		uint64_t key = pack(words[i]);
+		if (key == 0)
+			valid[i] = dictionary.check_word(words[i]);
+		else
+		{
+			batch.push_back(key);
+			index.push_back(i);
+		}
+	}
+
+	if (keys.empty())
+		return;
+
+	// search several keys in lockstep so their memory accesses overlap
+	for (size_t start = 0; start < batch.size(); start += lanes)
+	{
+		size_t count = std::min<size_t>(lanes, batch.size() - start);
+
+		uint64_t key[lanes] {};
+		size_t base[lanes] {};
+		for (size_t j = 0; j < count; ++j)
+			key[j] = batch[start + j];
+
+		size_t n = keys.size();
+		while (n > 1)
+		{
+			size_t half = n / 2;
+			for (size_t j = 0; j < lanes; ++j)
+				base[j] = (keys[base[j] + half] <= key[j]) ? base[j] + half : base[j];
+			n -= half;
+		}
+
+		for (size_t j = 0; j < count; ++j)
+			valid[index[start + j]] = keys[base[j]] == key[j];
+	}
+}
@@ -0,0 +1,51 @@
+#ifndef PACKED_WORDS_HPP
+#define PACKED_WORDS_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Dictionary;
+
+// short words packed 5 bits per letter into sorted 64-bit keys, for checking
+// many words at once. longer words are passed on to the dictionary
+class PackedWords
+{
+	std::vector<uint64_t> keys;
+	const Dictionary& dictionary;
+
+	// how many searches to run side by side
+	static const unsigned int lanes {8};
+
+	// index of last key <= key (or 0), without branching on the comparisons
+	inline size_t search(uint64_t key) const
+	{
+		size_t base = 0;
+		size_t n = keys.size();
+		while (n > 1)
+		{
+			size_t half = n / 2;
+			base = (keys[base + half] <= key) ? base + half : base;
+			n -= half;
+		}
+		return base;
+	}
+public:
+	static const unsigned int max_length {12};
+
+	// letters as 1-26, first letter highest. 0 if the word is too long or not A-Z
+	static uint64_t pack(const std::string& word);
+
+	PackedWords(const Dictionary& dict);
+
+	bool check_word(const std::string& word) const;
+	// set valid[i] to whether words[i] is a word
+	void check_words(const std::vector<std::string>& words, std::vector<bool>& valid) const;
+
+	inline size_t footprint() const
+	{
+		return keys.size() * sizeof(uint64_t);
+	}
+};
+
+#endif
@@ -0,0 +1,60 @@
+#include <stdexcept>
+
+#include "rack.hpp"
+
+using std::string;
+
+void Rack::add(char ch, unsigned int n)
+{
+	if (ch < 'A' || ch > 'Z')
+		throw std::runtime_error("attempt to add non-letter to rack");
+
+	counts[ch - 'A'] += n;
+	total += n;
+}
+
+void Rack::add(const string& letters)
+{
+	for (char ch : letters)
+		add(ch);
+}
+
+bool Rack::remove(char ch)
+{
+	if (ch < 'A' || ch > 'Z' || counts[ch - 'A'] == 0)
+		return false;
+
+	--counts[ch - 'A'];
+	--total;
+	return true;
+}
+
+bool Rack::remove(const string& word)
+{
+	std::array<unsigned int, 26> needed {};
+	for (char ch : word)
+	{
+		if (ch < 'A' || ch > 'Z' || ++needed[ch - 'A'] > counts[ch - 'A'])
+			return false;
+	}
+
+	for (unsigned int i = 0; i < 26; ++i)
+		counts[i] -= needed[i];
+	total -= word.size();
+	return true;
+}
+
+void Rack::clear()
+{
+	counts.fill(0);
+	total = 0;
+}
+
+string Rack::letters() const
+{
+	string all;
+	all.reserve(total);
+	for (unsigned int i = 0; i < 26; ++i)
+		all.append(counts[i], 'A' + i);
+	return all;
+}
@@ -0,0 +1,56 @@
+#ifndef RACK_HPP
+#define RACK_HPP
+
+#include <array>
+#include <string>
+
+// letters in a hand, without any graphics
+//
+// just counts per letter, so the server, bots and benchmarks can keep hands
+// the same way the client does. Hand keeps one alongside its tiles
+class Rack
+{
+	std::array<unsigned int, 26> counts {};
+	unsigned int total {0};
+public:
+	inline unsigned int count(char ch) const
+	{
+		return counts[ch - 'A'];
+	}
+
+	inline bool has_any(char ch) const
+	{
+		return count(ch) > 0;
+	}
+
+	inline unsigned int size() const
+	{
+		return total;
+	}
+
+	inline bool is_empty() const
+	{
+		return total == 0;
+	}
+
+	// number of each letter, e.g. for AnagramIndex
+	inline const std::array<unsigned int, 26>& get_counts() const
+	{
+		return counts;
+	}
+
+	// add n of letter ch
+	void add(char ch, unsigned int n = 1);
+	// add every letter in letters
+	void add(const std::string& letters);
+	// take one ch out, returning false if there is none
+	bool remove(char ch);
+	// take out every letter in word, or none of them if some are missing
+	bool remove(const std::string& word);
+	void clear();
+
+	// all letters in alphabetical order
+	std::string letters() const;
+};
+
+#endif
@@ -5,10 +5,10 @@ using std::cerr;
 using std::endl;
 using std::string;
 
-Server::Server(unsigned short port, const std::string& _dict_filename, uint8_t _num, uint8_t _den, unsigned int _max_players)
+Server::Server(unsigned short port, const std::string& _dict_filename, uint8_t _num, uint8_t _den, unsigned int _max_players, Share share, bool pack)
 	: shutdown_signal(false),
 	  status(Server::Status::LOADING),
-	  thread(&Server::start, this, port, _dict_filename, _num, _den, _max_players),
+	  thread(&Server::start, this, port, _dict_filename, _num, _den, _max_players, share, pack),
 	  dict_filename(_dict_filename),
 	  num(_num),
 	  den(_den)
@@ -69,7 +69,7 @@ Server::Server(std::ifstream& save_file)
 	save_file.clear();
 	save_file.seekg(0);
 
-	thread = std::thread(&Server::start, this, default_server_port, dict_filename, num, den, 1);
+	thread = std::thread(&Server::start, this, default_server_port, dict_filename, num, den, 1, Share::NONE, false);
 }
 
 Server::~Server()
@@ -78,7 +78,33 @@ Server::~Server()
 	block();
 }
 
-void Server::start(unsigned short port, const std::string& _dict_filename, uint8_t _num, uint8_t _den, unsigned int _max_players)
+std::unique_ptr<Server::Shared> Server::prepare(const std::shared_ptr<const Dictionary>& dictionary, Share share, bool pack)
+{
+	std::unique_ptr<Shared> shared {new Shared()};
+	shared->dictionary = dictionary;
+	if (!dictionary)
+		return shared;
+
+	// here rather than on the first peel, which would stall the game thread
+	if (pack)
+		dictionary->pack();
+
+	shared->checksum = dictionary->checksum();
+
+	if (share == Share::DICTIONARY)
+		shared->kind = 1;
+	else if (share == Share::BLOOM)
+	{
+		BloomFilter bloom {dictionary->size()};
+		dictionary->each_word([&bloom](const string& word) { bloom.add(word); });
+		shared->bloom = bloom.serialize();
+		shared->kind = 2;
+	}
+
+	return shared;
+}
+
+void Server::start(unsigned short port, const std::string& _dict_filename, uint8_t _num, uint8_t _den, unsigned int _max_players, Share share, bool pack)
 {
 	sf::UdpSocket socket;
 	if (port == 0 || socket.bind(port) != sf::Socket::Status::Done)
@@ -98,9 +124,16 @@ void Server::start(unsigned short port, const std::string& _dict_filename, uint8
 
 	Game game(_dict_filename, _num, _den, counts, _max_players);
 
+	std::unique_ptr<Shared> shared {prepare(game.get_dictionary(), share, pack)};
+
+	// replacement dictionary being loaded in the background
+	std::future<std::unique_ptr<Shared>> reloading;
+	float reload_poll {0.f};
+
 	{
 		std::lock_guard<std::mutex> lock(status_lock);
 		status = Status::RUNNING;
+		dictionary = shared->dictionary;
 	}
 
 	cout << "\nWaiting for players to join...";
@@ -163,11 +196,59 @@ void Server::start(unsigned short port, const std::string& _dict_filename, uint8
 			remove.clear();
 		}
 
-		// check if we got a shutdown signal
+		// check if we got a shutdown or reload signal
 		bool need_to_shutdown;
+		bool need_to_reload;
 		{
 			std::lock_guard<std::mutex> lock(shutdown_lock);
 			need_to_shutdown = shutdown_signal;
+			// left set until a reload actually starts
+			need_to_reload = reload_signal;
+		}
+
+		// look for a changed dictionary file every couple of seconds
+		reload_poll += elapsed;
+		if (!_dict_filename.empty() && !reloading.valid() && (need_to_reload || (reload_poll > 2.f && DictionaryCache::changed(_dict_filename))))
+		{
+			cout << "\nReloading dictionary...";
+			cout.flush();
+
+			if (need_to_reload)
+			{
+				std::lock_guard<std::mutex> lock(shutdown_lock);
+				reload_signal = false;
+			}
+
+			// build it off the game thread, games keep running meanwhile
+			string filename {_dict_filename};
+			reloading = std::async(std::launch::async, [filename, share, pack, need_to_reload]()
+			{
+				return prepare(need_to_reload ? DictionaryCache::reload(filename) : DictionaryCache::get(filename), share, pack);
+			});
+		}
+		if (reload_poll > 2.f)
+			reload_poll = 0.f;
+
+		// swap it in between ticks, but only while nobody is using the old one.
+		// players who joined may have downloaded it, so they keep it until the
+		// game ends and the restarted server picks up the new one
+		if (reloading.valid() && !game.in_progress() && game.get_players().empty()
+			&& reloading.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+		{
+			std::unique_ptr<Shared> fresh {reloading.get()};
+			if (!fresh->dictionary)
+				cout << "\nFailed to reload dictionary, keeping the old one";
+			else if (fresh->checksum != shared->checksum)
+			{
+				game.set_dictionary(fresh->dictionary);
+				shared = std::move(fresh);
+				{
+					std::lock_guard<std::mutex> lock(status_lock);
+					dictionary = shared->dictionary;
+				}
+				cout << "\nLoaded new dictionary (" << shared->dictionary->size() << " words)";
+			}
+			cout.flush();
 		}
 		if (need_to_shutdown)
 		{
@@ -374,11 +455,36 @@ void Server::start(unsigned short port, const std::string& _dict_filename, uint8
 			}
 			case cl_check:
 			{
-				string word;
-				packet >> word;
+				sf::Int16 check_n;
+				sf::Uint16 count;
+				packet >> check_n >> count;
+
+				std::vector<string> words(count);
+				for (auto& word : words)
+					if (!(packet >> word))
+						break;
+
+				if (!packet)
+				{
+					cout << "\nMalformed check from " << game.get_player_name(id);
+					cout.flush();
+					break;
+				}
+
+				// check the whole batch at once
+				std::vector<bool> valid;
+				game.check_words(words, valid);
+
+				// one bit per word, in the order they were sent
+				std::vector<sf::Uint8> bitmap((count + 7) / 8, 0);
+				for (unsigned int i = 0; i < count; ++i)
+					if (valid[i])
+						bitmap[i / 8] |= 1 << (i % 8);
 
 				sf::Packet lookup;
-				lookup << sv_check << word << game.check_word(word);
+				lookup << sv_check << check_n << count;
+				for (auto byte : bitmap)
+					lookup << byte;
 
 				// TODO store definition to tell everyone about on next peel?
 
@@ -386,6 +492,32 @@ void Server::start(unsigned short port, const std::string& _dict_filename, uint8
 
 				break;
 			}
+			case cl_dict:
+			{
+				sf::Uint32 chunk;
+				packet >> chunk;
+
+				// clients use the checksum to key their word caches
+				sf::Packet reply;
+				reply << sv_dict << sf::Uint32(shared->checksum >> 32) << sf::Uint32(shared->checksum);
+
+				if (shared->kind != 0)
+				{
+					sf::Uint32 size = shared->size();
+					sf::Uint32 chunks = (size + dict_chunk_size - 1) / dict_chunk_size;
+					if (chunk >= chunks)
+						break;
+
+					sf::Uint32 begin = chunk * dict_chunk_size;
+					reply << shared->kind << chunk << chunks << string(shared->data() + begin, std::min(dict_chunk_size, size - begin));
+				}
+				else // nothing to send
+					reply << sf::Uint8(0) << chunk << sf::Uint32(0);
+
+				socket.send(reply, client_ip, client_port);
+
+				break;
+			}
 			case cl_dump:
 			{
 				if (game.is_finished())
@@ -525,6 +657,12 @@ void Server::shutdown()
 	shutdown_signal = true;
 }
 
+void Server::reload()
+{
+	std::lock_guard<std::mutex> lock(shutdown_lock);
+	reload_signal = true;
+}
+
 Server::Status Server::block()
 {
 	{
@@ -542,3 +680,9 @@ Server::Status Server::get_status()
 	std::lock_guard<std::mutex> lock(status_lock);
 	return status;
 }
+
+std::shared_ptr<const Dictionary> Server::get_dictionary()
+{
+	std::lock_guard<std::mutex> lock(status_lock);
+	return dictionary;
+}
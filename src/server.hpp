@@ -2,13 +2,16 @@
 #define SERVER_HPP
 
 #include <chrono>
+#include <future>
 #include <iostream> // TODO handle output in server main
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 
 #include <SFML/Network.hpp>
 
+#include "bloom.hpp"
 #include "constants.hpp"
 #include "game.hpp"
 
@@ -16,18 +19,46 @@ class Server
 {
 public:
 	enum class Status {LOADING, RUNNING, ABORTED, DONE};
+	// what to send clients so they can check words themselves
+	enum class Share {NONE, BLOOM, DICTIONARY};
 
 private:
+	// dictionary along with what we send in response to cl_dict
+	struct Shared
+	{
+		std::shared_ptr<const Dictionary> dictionary;
+		uint64_t checksum {0};
+		// 0: nothing, 1: binary dictionary image, 2: bloom filter
+		sf::Uint8 kind {0};
+		std::string bloom;
+
+		inline const char* data() const
+		{
+			return kind == 1 ? dictionary->image() : bloom.data();
+		}
+
+		inline sf::Uint32 size() const
+		{
+			return kind == 1 ? dictionary->image_size() : bloom.size();
+		}
+	};
+
+	// work out what to share and pack the dictionary if asked to, can be slow
+	static std::unique_ptr<Shared> prepare(const std::shared_ptr<const Dictionary>& dictionary, Share share, bool pack);
+
 	std::mutex shutdown_lock;
 	bool shutdown_signal;
+	bool reload_signal {false};
 
 	std::mutex status_lock;
 	Status status;
+	// dictionary the game checks words with, set once running
+	std::shared_ptr<const Dictionary> dictionary;
 
 	std::thread thread;
 
 	// function to be run in thread
-	void start(unsigned short port, const std::string& _dict_filename, uint8_t _num, uint8_t _den, unsigned int _max_players);
+	void start(unsigned short port, const std::string& _dict_filename, uint8_t _num, uint8_t _den, unsigned int _max_players, Share share, bool pack);
 
 	// for saving the game
 	std::string dict_filename;
@@ -36,7 +67,8 @@ private:
 	unsigned int* counts = nullptr;
 public:
 	// just passes along params to thread
-	Server(unsigned short port, const std::string& _dict_filename, uint8_t _num, uint8_t _den, unsigned int _max_players);
+	// pack keeps short words as sorted keys for checking peels, see Dictionary::pack
+	Server(unsigned short port, const std::string& _dict_filename, uint8_t _num, uint8_t _den, unsigned int _max_players, Share share = Share::NONE, bool pack = false);
 	// for single player
 	Server(const std::string& _dict_filename, uint8_t _num, uint8_t _den);
 	// load game
@@ -46,6 +78,8 @@ public:
 
 	// tell server thread to return
 	void shutdown();
+	// tell server thread to load its dictionary file again
+	void reload();
 	// block until thread returns
 	Status block();
 
@@ -65,6 +99,8 @@ public:
 	}
 
 	Status get_status();
+	// dictionary loaded by the server thread, nullptr until it is running
+	std::shared_ptr<const Dictionary> get_dictionary();
 };
 
 #endif
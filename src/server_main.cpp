@@ -21,6 +21,14 @@ void shutdown(int s)
 	server->shutdown();
 }
 
+// callback for hangup signal
+void reload(int s)
+{
+	(void)s; // intentionally unused
+
+	server->reload();
+}
+
 int main(int argc, char* argv[])
 {
 #ifndef __MINGW32__
@@ -33,16 +41,26 @@ int main(int argc, char* argv[])
 	sigaction(SIGINT , &action, nullptr);
 	sigaction(SIGTERM, &action, nullptr);
 	sigaction(SIGKILL, &action, nullptr);
+
+	// reload dictionary on hangup
+	struct sigaction hangup;
+	hangup.sa_handler = reload;
+	sigemptyset(&hangup.sa_mask);
+	hangup.sa_flags = 0;
+
+	sigaction(SIGHUP, &hangup, nullptr);
 #endif
 
 	// command line arguments
 	po::options_description desc("Bananagrams dedicated server options");
 	desc.add_options()
 		("help",                                                                   "show options")
-		("dict",  po::value<string>()->required(),                                 "dictionary file")
+		("dict",  po::value<string>()->default_value(""),                          "dictionary file, reloaded when it changes or on SIGHUP (default: built-in word list). replace it by renaming a new file over it, as dictc does")
 		("port",  po::value<unsigned short>()->default_value(default_server_port), "TCP/UDP listening port")
 		("bunch", po::value<string>()->default_value("1"),                         "bunch multiplier (0.5 or a positive integer)")
 		("limit", po::value<unsigned int>(),                                       "player limit")
+		("share", po::value<string>()->default_value("none"),                      "what clients get to check words themselves (none, bloom or dict)")
+		("packed",                                                                 "keep short words as sorted keys for checking peels, uses about 1.2 MB more memory")
 	;
 
 	po::variables_map opts;
@@ -113,10 +131,25 @@ int main(int argc, char* argv[])
 
 	string dict = opts["dict"].as<string>();
 
+	// check share option
+	Server::Share share;
+	string share_s {opts["share"].as<string>()};
+	if (share_s == "none")
+		share = Server::Share::NONE;
+	else if (share_s == "bloom")
+		share = Server::Share::BLOOM;
+	else if (share_s == "dict")
+		share = Server::Share::DICTIONARY;
+	else
+	{
+		cerr << "Error: invalid share option " << share_s << endl;
+		return 1;
+	}
+
 	bool done = false;
 	while (!done)
 	{
-		server = new Server(server_port, dict, b_num, b_den, max_players);
+		server = new Server(server_port, dict, b_num, b_den, max_players, share, opts.count("packed") > 0);
 
 		switch(server->block())
 		{
@@ -11,8 +11,6 @@ class Tile
 	sf::Sprite sprite;
 	sf::Vector2i gpos {0, 0}; // position on grid (not always meaningful)
 public:
-	bool marked; // for checking grid connectedness
-
 	static sf::RenderTexture texture[26];
 
 	Tile(char ch);